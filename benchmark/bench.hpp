@@ -0,0 +1,165 @@
+#pragma once
+#include <atomic>   // atomic
+#include <chrono>   // steady_clock
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <cstdio>   // printf
+#include <cstdlib>  // malloc, free
+#include <new>      // operator new
+#include <string>   // string
+#include <vector>   // vector
+
+/***
+ * @brief benchmark helpers
+ * @details Shared by every benchmark executable. Each benchmark is a single
+ * translation unit, so this header also replaces the global operator new /
+ * delete to count heap allocations. Do NOT include it twice in one program.
+ * @author qingl
+ * @date 2026_10_17
+ */
+namespace bench {
+// heap allocation statistics
+struct alloc_stats {
+    std::uint64_t count = 0; // number of operator new calls
+    std::uint64_t bytes = 0; // total bytes requested
+};
+
+// counters updated by operator new, safe to use from several threads
+struct alloc_counters {
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> bytes{0};
+
+    alloc_stats load() const { return {count.load(), bytes.load()}; }
+};
+
+inline alloc_counters& counters() {
+    static alloc_counters c;
+    return c;
+}
+
+inline alloc_stats stats() { return counters().load(); }
+
+// pseudo random number generator (xorshift64*), deterministic across runs
+class random {
+private:
+    std::uint64_t m_state;
+
+public:
+    explicit random(std::uint64_t seed = 0x9E3779B97F4A7C15ull)
+        : m_state(seed) {}
+
+    std::uint64_t next() {
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545F4914F6CDD1Dull;
+    }
+
+    // [0, n)
+    std::size_t uniform(std::size_t n) { return std::size_t(next() % n); }
+
+    // [0, 1)
+    double real() { return double(next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+/***
+ * @brief run f() repeatedly and report time and allocations per call
+ * @details f is warmed up once, then repeated until at least min_seconds
+ * elapsed. bytes is the size of the processed input, used for MB/s.
+ */
+template <typename Function>
+void run(const char* name, std::size_t bytes, Function&& f,
+         double min_seconds = 0.5) {
+    f(); // warm up
+
+    using clock = std::chrono::steady_clock;
+    std::uint64_t iterations = 0;
+    alloc_stats before = stats();
+    auto start = clock::now();
+    double elapsed = 0;
+    do {
+        f();
+        iterations++;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < min_seconds);
+    alloc_stats after = stats();
+
+    double seconds = elapsed / double(iterations);
+    double mb = double(bytes) / (1024.0 * 1024.0);
+    double allocs = double(after.count - before.count) / double(iterations);
+    std::printf("%-32s %10.3f ms  %9.2f MB/s  %12.0f allocs  %10.0f "
+                "allocs/MB\n",
+                name, seconds * 1e3, mb / seconds, allocs,
+                mb > 0 ? allocs / mb : 0.0);
+}
+
+// keep the optimizer from discarding a result
+template <typename T>
+inline void do_not_optimize(T const& value) {
+#if defined(_MSC_VER)
+    static volatile const void* sink;
+    sink = &value;
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/***
+ * @brief generate a JSON document of about `target_bytes` bytes
+ * @details An array of records mixing objects, nested arrays, strings,
+ * numbers and literals, similar to an API response.
+ */
+inline std::string make_document(std::size_t target_bytes,
+                                 std::uint64_t seed = 1) {
+    random rng(seed);
+    std::string out = "[";
+    char number[32];
+    for (std::size_t id = 0; out.size() < target_bytes; id++) {
+        if (id != 0)
+            out += ',';
+        out += "{\"id\":";
+        out += std::to_string(id);
+        out += ",\"name\":\"user_";
+        out += std::to_string(rng.uniform(100000));
+        out += "\",\"active\":";
+        out += (rng.next() & 1) ? "true" : "false";
+        out += ",\"score\":";
+        std::snprintf(number, sizeof(number), "%.6f", rng.real() * 1000.0);
+        out += number;
+        out += ",\"tags\":[\"alpha\",\"beta\",\"gamma\"],\"location\":{"
+               "\"lat\":";
+        std::snprintf(number, sizeof(number), "%.7f",
+                      rng.real() * 180.0 - 90.0);
+        out += number;
+        out += ",\"lng\":";
+        std::snprintf(number, sizeof(number), "%.7f",
+                      rng.real() * 360.0 - 180.0);
+        out += number;
+        out += "},\"note\":null,\"history\":[";
+        for (int i = 0; i < 4; i++) {
+            if (i != 0)
+                out += ',';
+            out += std::to_string(rng.uniform(1000000));
+        }
+        out += "]}";
+    }
+    out += ']';
+    return out;
+}
+} // namespace bench
+
+// count every heap allocation of the benchmark process
+// (gcc can not see that the replaced operator new uses malloc)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(std::size_t size) {
+    bench::counters().count.fetch_add(1, std::memory_order_relaxed);
+    bench::counters().bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
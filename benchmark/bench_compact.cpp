@@ -0,0 +1,79 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+using json = microlife::json;
+using compact_json = microlife::compact::json;
+
+namespace {
+std::string make_numbers(std::size_t count) {
+    bench::random rng;
+    std::string out = "[";
+    char number[32];
+    for (std::size_t i = 0; i < count; i++) {
+        if (i != 0)
+            out += ',';
+        std::snprintf(number, sizeof(number), "%.6f", rng.real() * 1000.0);
+        out += number;
+    }
+    out += ']';
+    return out;
+}
+
+// sum of every number below j
+template <typename Json>
+double sum(Json& j) {
+    switch (j.type()) {
+    case Json::value_t::number:
+        return j.template get<double>();
+    case Json::value_t::array: {
+        double ret = 0;
+        for (auto& i : j.template get<typename Json::array_t&>())
+            ret += sum(i);
+        return ret;
+    }
+    case Json::value_t::object: {
+        double ret = 0;
+        for (auto& i : j.template get<typename Json::object_t&>())
+            ret += sum(i.second);
+        return ret;
+    }
+    default:
+        return 0;
+    }
+}
+
+template <typename Json>
+void measure(const char* name, const std::string& text) {
+    auto before = bench::stats();
+    Json j;
+    j.parse(text);
+    auto after = bench::stats();
+    std::printf("%s: %zu byte nodes, %llu heap bytes (%.2fx the text)\n",
+                name, sizeof(Json), (unsigned long long)(after.bytes -
+                                                         before.bytes),
+                double(after.bytes - before.bytes) / double(text.size()));
+
+    bench::run("  parse", text.size(), [&] {
+        Json k;
+        k.parse(text);
+        bench::do_not_optimize(k);
+    });
+    bench::run("  traverse (sum numbers)", text.size(), [&] {
+        double s = sum(j);
+        bench::do_not_optimize(s);
+    });
+}
+} // namespace
+
+// default tagged layout versus the NaN-boxed compact layout
+int main() {
+    auto numbers = make_numbers(1000000);
+    std::printf("1M numbers: %zu bytes\n", numbers.size());
+    measure<json>("json", numbers);
+    measure<compact_json>("compact::json", numbers);
+
+    auto document = bench::make_document(16 * 1024 * 1024);
+    std::printf("document: %zu bytes\n", document.size());
+    measure<json>("json", document);
+    measure<compact_json>("compact::json", document);
+}
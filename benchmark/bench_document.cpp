@@ -0,0 +1,52 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <cstring> // memcpy
+
+using json = microlife::json;
+using document = microlife::document;
+
+// parse and free: basic_json (one allocation per value) versus the arena,
+// and the arena without copies of the strings (borrowed or in situ)
+int main() {
+    for (std::size_t size : {4 * 1024, 64 * 1024, 16 * 1024 * 1024}) {
+        auto text = bench::make_document(size);
+        std::printf("document: %zu bytes\n", text.size());
+
+        bench::run("json::parse + destroy", text.size(), [&] {
+            json j;
+            j.parse(text);
+            bench::do_not_optimize(j);
+        });
+
+        bench::run("document, new per parse", text.size(), [&] {
+            document doc;
+            doc.parse(text);
+            bench::do_not_optimize(doc.root());
+        });
+
+        document doc;
+        bench::run("document, reused", text.size(), [&] {
+            doc.parse(text);
+            bench::do_not_optimize(doc.root());
+        });
+        std::printf("arena: %zu bytes used\n", doc.memory_usage());
+
+        // strings are views into text
+        bench::run("document, borrowed", text.size(), [&] {
+            doc.borrow(text);
+            bench::do_not_optimize(doc.root());
+        });
+        std::printf("arena: %zu bytes used\n", doc.memory_usage());
+
+        // strings decoded in a buffer the caller owns, filled like a
+        // receive buffer
+        std::string buffer(text.size(), '\0');
+        bench::run("document, in situ (+ copy)", text.size(), [&] {
+            std::memcpy(&buffer[0], text.data(), text.size());
+            doc.parse_in_situ(&buffer[0], buffer.size());
+            bench::do_not_optimize(doc.root());
+        });
+        std::printf("arena: %zu bytes used\n", doc.memory_usage());
+    }
+}
@@ -0,0 +1,87 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <fcntl.h>  // open
+#include <sstream>  // ostringstream
+#include <unistd.h> // close
+
+using json = microlife::json;
+
+namespace {
+// the previous implementation: every level returns a new string
+std::string dump_recursive(json& j) {
+    switch (j.type()) {
+    case json::value_t::array: {
+        std::string ret = "[";
+        for (auto& i : j.get<json::array_t&>()) {
+            ret += dump_recursive(i);
+            ret.push_back(',');
+        }
+        if (ret.size() > 1)
+            ret.pop_back();
+        ret.push_back(']');
+        return ret;
+    }
+    case json::value_t::object: {
+        std::string ret = "{";
+        for (auto& i : j.get<json::object_t&>()) {
+            ret += '\"' + i.first + '\"' + ':';
+            ret += dump_recursive(i.second);
+            ret.push_back(',');
+        }
+        if (ret.size() > 1)
+            ret.pop_back();
+        ret.push_back('}');
+        return ret;
+    }
+    default:
+        return j.dump();
+    }
+}
+} // namespace
+
+// serialization: recursive string concatenation versus the serializer
+int main() {
+    const std::size_t sizes[] = {64 * 1024, 16 * 1024 * 1024};
+    for (std::size_t size : sizes) {
+        json doc;
+        doc.parse(bench::make_document(size));
+        const std::size_t bytes = doc.dump().size();
+        std::printf("document: %zu bytes\n", bytes);
+
+        bench::run("recursive concatenation", bytes, [&] {
+            bench::do_not_optimize(dump_recursive(doc));
+        });
+        bench::run("dump() -> std::string", bytes,
+                   [&] { bench::do_not_optimize(doc.dump()); });
+
+        std::string reused;
+        bench::run("dump(string&), reused", bytes, [&] {
+            reused.clear();
+            doc.dump(reused);
+            bench::do_not_optimize(reused);
+        });
+
+        std::vector<char> buffer(bytes);
+        bench::run("dump(char*, size)", bytes, [&] {
+            bench::do_not_optimize(doc.dump(buffer.data(), buffer.size()));
+        });
+
+        std::ostringstream os;
+        bench::run("operator<< (ostringstream)", bytes, [&] {
+            os.str(std::string());
+            os << doc;
+        });
+
+        std::FILE* null_file = std::fopen("/dev/null", "w");
+        bench::run("dump(FILE*) /dev/null", bytes, [&] { doc.dump(null_file); });
+        std::fclose(null_file);
+
+        int fd = open("/dev/null", O_WRONLY);
+        bench::run("fd_output_adapter /dev/null", bytes, [&] {
+            microlife::detail::fd_output_adapter out(fd);
+            doc.dump_to(out);
+        });
+        close(fd);
+    }
+}
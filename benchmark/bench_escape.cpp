@@ -0,0 +1,102 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+using json = microlife::json;
+using simd = microlife::detail::simd;
+
+namespace {
+// log lines: long strings, a quote or a newline once in a while
+std::vector<std::string> make_log_lines(std::size_t count) {
+    bench::random rng;
+    const char* const words[] = {"request", "GET",    "/api/v1/users", "200",
+                              "latency", "12.5ms", "user_agent",    "curl/8.0",
+                              "cache",   "miss",   "upstream",      "ok"};
+    std::vector<std::string> lines;
+    for (std::size_t i = 0; i < count; i++) {
+        std::string line;
+        while (line.size() < 200) {
+            line += words[rng.uniform(12)];
+            line += rng.uniform(40) == 0 ? '"' : ' ';
+        }
+        if (rng.uniform(4) == 0)
+            line += '\n';
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+// the previous implementation: one switch and push_back per character
+void escape_bytewise(const std::string& s, std::string& ret) {
+    static const char hex_digits[] = "0123456789ABCDEF";
+    ret.push_back('\"');
+    for (char c : s) {
+        auto ch = static_cast<unsigned char>(c);
+        switch (ch) {
+        case '\"':
+            ret += "\\\"";
+            break;
+        case '\\':
+            ret += "\\\\";
+            break;
+        case '\n':
+            ret += "\\n";
+            break;
+        default:
+            if (ch < 0x20) {
+                ret += "\\u00";
+                ret.push_back(hex_digits[ch >> 4]);
+                ret.push_back(hex_digits[ch & 15]);
+            } else
+                ret.push_back(c);
+        }
+    }
+    ret.push_back('\"');
+}
+} // namespace
+
+// string escaping: byte by byte versus the find_escape() kernels
+int main() {
+    auto lines = make_log_lines(100000);
+    std::size_t bytes = 0;
+    json doc(json::value_t::array);
+    for (auto& l : lines) {
+        bytes += l.size();
+        doc.get<json::array_t&>().push_back(l);
+    }
+    std::printf("%zu strings, %zu bytes, best level %d\n", lines.size(), bytes,
+                int(simd::detect()));
+
+    std::string out;
+    bench::run("byte by byte (previous)", bytes, [&] {
+        out.clear();
+        for (auto& l : lines)
+            escape_bytewise(l, out);
+        bench::do_not_optimize(out);
+    });
+
+    const char* names[] = {"find_escape scalar", "find_escape sse2",
+                           "find_escape avx2"};
+    for (auto l : {simd::level::scalar, simd::level::sse2, simd::level::avx2}) {
+        auto f = simd::find_escape_function(l);
+        if (f == nullptr || l > simd::detect())
+            continue;
+        bench::run(names[int(l)], bytes, [&] {
+            std::size_t found = 0;
+            for (auto& s : lines) {
+                const char* p = s.data();
+                const char* last = p + s.size();
+                while ((p = f(p, last)) != last) {
+                    found++;
+                    p++;
+                }
+            }
+            bench::do_not_optimize(found);
+        });
+    }
+
+    bench::run("json::dump(string&)", bytes, [&] {
+        out.clear();
+        doc.dump(out);
+        bench::do_not_optimize(out);
+    });
+}
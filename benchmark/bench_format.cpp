@@ -0,0 +1,81 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <cstring> // memcpy
+
+using json = microlife::json;
+using number_formatter = microlife::detail::number_formatter;
+
+namespace {
+// total length of every value printed with sprintf("%.17g")
+std::size_t format_sprintf(const std::vector<double>& values) {
+    std::size_t n = 0;
+    char buffer[32];
+    for (double v : values)
+        n += std::size_t(std::sprintf(buffer, "%.17g", v));
+    return n;
+}
+
+// total length of every value printed with number_formatter
+std::size_t format_shortest(const std::vector<double>& values) {
+    std::size_t n = 0;
+    char buffer[number_formatter::buffer_size];
+    for (double v : values)
+        n += std::size_t(number_formatter::format_double(buffer, v) - buffer);
+    return n;
+}
+} // namespace
+
+// number formatting: sprintf("%.17g") versus the shortest round-trip output
+int main() {
+    const std::size_t count = 1000000;
+    bench::random rng;
+
+    struct {
+        const char* name;
+        std::vector<double> values;
+    } sets[] = {{"integers", {}},
+                {"telemetry (6 decimals)", {}},
+                {"doubles", {}},
+                {"random bits", {}}};
+    for (std::size_t i = 0; i < count; i++) {
+        sets[0].values.push_back(double(rng.next() >> 40));
+        sets[1].values.push_back(double(rng.next() % 1000000000) / 1e6);
+        sets[2].values.push_back(rng.real() * 1e10);
+        std::uint64_t bits = rng.next() & 0x7FEFFFFFFFFFFFFFull; // finite
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        sets[3].values.push_back(v);
+    }
+
+    for (auto& s : sets) {
+        std::size_t old_bytes = format_sprintf(s.values);
+        std::size_t new_bytes = format_shortest(s.values);
+        std::printf("%s: %%.17g %zu bytes, shortest %zu bytes\n", s.name,
+                    old_bytes, new_bytes);
+        bench::run("sprintf %.17g", old_bytes, [&] {
+            bench::do_not_optimize(format_sprintf(s.values));
+        });
+        bench::run("number_formatter", new_bytes, [&] {
+            bench::do_not_optimize(format_shortest(s.values));
+        });
+    }
+
+    // dump of a number array
+    json doc;
+    std::string text = "[";
+    for (std::size_t i = 0; i < count; i++) {
+        if (i != 0)
+            text += ',';
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.6f", rng.real() * 1000);
+        text += buffer;
+    }
+    text += ']';
+    doc.parse(text);
+    std::size_t dumped = doc.dump().size();
+    std::printf("json::dump of %zu numbers: %zu -> %zu bytes\n", count,
+                text.size(), dumped);
+    bench::run("json::dump", dumped,
+               [&] { bench::do_not_optimize(doc.dump()); });
+}
@@ -0,0 +1,73 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <cstdint> // uint64_t
+#include <cstdlib> // strtoull
+
+using json = microlife::json;
+using compact_json = microlife::compact::json;
+
+namespace {
+// records with 64 bit ids (above 2^53), counters and timestamps, as
+// returned by an API
+std::string make_records(std::size_t target_bytes) {
+    bench::random rng;
+    std::string out = "[";
+    for (std::uint64_t i = 0; out.size() < target_bytes; i++) {
+        if (i != 0)
+            out += ',';
+        out += "{\"id\":";
+        out += std::to_string(1500000000000000000ull + i * 4194304 +
+                              rng.uniform(4096));
+        out += ",\"user\":";
+        out += std::to_string(rng.uniform(100000000));
+        out += ",\"likes\":";
+        out += std::to_string(rng.uniform(1000));
+        out += ",\"created\":";
+        out += std::to_string(1790000000 + i);
+        out += ",\"offset\":-";
+        out += std::to_string(rng.uniform(50000));
+        out += '}';
+    }
+    out += ']';
+    return out;
+}
+
+// number of ids read back exactly from the parsed records
+template <typename Json>
+std::size_t exact_ids(const std::string& text) {
+    Json j;
+    j.parse(text);
+    std::size_t ret = 0, pos = 0;
+    for (const auto& i : j.template get<const typename Json::array_t&>()) {
+        pos = text.find("\"id\":", pos) + 5;
+        auto id = std::strtoull(text.c_str() + pos, nullptr, 10);
+        ret += i.at("id").template get<std::uint64_t>() == id;
+    }
+    return ret;
+}
+
+template <typename Json>
+void measure(const char* name, const std::string& text) {
+    std::printf("%s: %zu ids read back exactly\n", name,
+                exact_ids<Json>(text));
+    Json j;
+    j.parse(text);
+    bench::run("  parse", text.size(), [&] {
+        Json k;
+        k.parse(text);
+        bench::do_not_optimize(k);
+    });
+    bench::run("  dump", text.size(),
+               [&] { bench::do_not_optimize(j.dump()); });
+}
+} // namespace
+
+// integer heavy documents: every number goes through the integer path of
+// the lexer (8 digits at a time) and of the serializer
+int main() {
+    auto records = make_records(16 * 1024 * 1024);
+    std::printf("records: %zu bytes\n", records.size());
+    measure<json>("json", records);
+    measure<compact_json>("compact::json", records);
+}
@@ -0,0 +1,91 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <chrono> // steady_clock
+
+#if defined(__GLIBC__)
+#include <malloc.h> // mallinfo2
+#endif
+
+using json = microlife::json;
+using ordered_json = microlife::ordered_json;
+using interned_json = microlife::interned_json;
+
+namespace {
+// one event per line, every record has the same keys
+std::string make_stream(std::size_t records) {
+    bench::random rng;
+    const char* const levels[] = {"debug", "info", "warn", "error"};
+    const char* const services[] = {"api", "auth", "billing", "search"};
+    std::string out;
+    for (std::size_t i = 0; i < records; i++) {
+        out += "{\"timestamp\":";
+        out += std::to_string(1700000000 + i);
+        out += ",\"level\":\"";
+        out += levels[rng.uniform(4)];
+        out += "\",\"service\":\"";
+        out += services[rng.uniform(4)];
+        out += "\",\"user_id\":";
+        out += std::to_string(rng.uniform(1000000));
+        out += ",\"http_status\":200,\"request_duration_ms\":";
+        out += std::to_string(rng.uniform(5000));
+        out += ",\"response_size_bytes\":";
+        out += std::to_string(rng.uniform(100000));
+        out += "}\n";
+    }
+    return out;
+}
+
+// bytes currently allocated from the heap, 0 if unknown
+std::size_t live_heap() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+// parse every line of stream, keep the records
+template <typename Json>
+void measure(const char* name, const std::string& stream) {
+    std::size_t heap_before = live_heap();
+    auto before = bench::stats();
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<Json> records;
+        std::size_t begin = 0;
+        while (begin < stream.size()) {
+            auto end = stream.find('\n', begin);
+            records.emplace_back();
+            records.back().parse(stream.data() + begin, end - begin);
+            begin = end + 1;
+        }
+        double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        auto after = bench::stats();
+        std::size_t heap = live_heap() - heap_before;
+        double mb = double(stream.size()) / (1024.0 * 1024.0);
+        std::printf("%-14s %9.2f MB/s  %9.2f allocs/record  %7.1f heap "
+                    "bytes/record  %7.1f live bytes/record\n",
+                    name, mb / seconds,
+                    double(after.count - before.count) / records.size(),
+                    double(after.bytes - before.bytes) / records.size(),
+                    double(heap) / records.size());
+    }
+}
+} // namespace
+
+// a stream of 1M records with the same keys: std::string keys per object
+// versus keys interned once in key_table::global()
+int main() {
+    const std::size_t records = 1000000;
+    auto stream = make_stream(records);
+    std::printf("stream: %zu records, %zu bytes\n", records, stream.size());
+    measure<json>("json", stream);
+    measure<ordered_json>("ordered_json", stream);
+    measure<interned_json>("interned_json", stream);
+    std::printf("key table: %zu keys, %zu bytes\n",
+                microlife::detail::key_table::global().size(),
+                microlife::detail::key_table::global().memory_usage());
+}
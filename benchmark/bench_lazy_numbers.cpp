@@ -0,0 +1,81 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <string> // string, to_string
+
+using document = microlife::document;
+
+namespace {
+// market data: prices and sizes with many decimals, the shape of a feed
+// that is forwarded with few fields read
+std::string make_quotes(std::size_t target_bytes) {
+    bench::random rng;
+    std::string out = "[";
+    char buf[64];
+    for (std::size_t i = 0; out.size() < target_bytes; i++) {
+        if (i != 0)
+            out += ',';
+        out += "{\"seq\":";
+        out += std::to_string(i);
+        std::snprintf(buf, sizeof(buf), ",\"bid\":%.17g,\"ask\":%.17g",
+                      100 * rng.real(), 100 * rng.real());
+        out += buf;
+        std::snprintf(buf, sizeof(buf), ",\"size\":%.9f,\"rate\":%.12e}",
+                      rng.real() * 1000, rng.real() / 1000);
+        out += buf;
+    }
+    out += ']';
+    return out;
+}
+} // namespace
+
+// numbers kept as text: parse + dump skips every conversion, reading all
+// values converts them on access
+int main() {
+    auto text = make_quotes(16 * 1024 * 1024);
+    std::printf("quotes: %zu bytes\n", text.size());
+
+    document::parse_options lazy;
+    lazy.lazy_numbers = true;
+
+    document doc;
+    for (bool is_lazy : {false, true}) {
+        std::printf("%s\n", is_lazy ? "lazy numbers" : "eager numbers");
+        document::parse_options options;
+        options.lazy_numbers = is_lazy;
+
+        bench::run("  parse", text.size(), [&] {
+            doc.parse(text, options);
+            bench::do_not_optimize(doc.root());
+        });
+
+        doc.parse(text, options);
+        bench::run("  dump", text.size(),
+                   [&] { bench::do_not_optimize(doc.dump()); });
+
+        // one field of every record
+        bench::run("  parse + read seq", text.size(), [&] {
+            doc.parse(text, options);
+            std::size_t sum = 0;
+            for (const auto& q : doc.root().elements())
+                sum += q["seq"].get<std::size_t>();
+            bench::do_not_optimize(sum);
+        });
+
+        bench::run("  parse + read all", text.size(), [&] {
+            doc.parse(text, options);
+            double sum = 0;
+            for (const auto& q : doc.root().elements()) {
+                for (const auto& m : q.items())
+                    sum += m.value.get<double>();
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    // the text is kept: decimals beyond double precision pass through
+    doc.parse("[0.1000000000000000000000000001]", lazy);
+    std::printf("lazy: %s\n", doc.dump().c_str());
+    doc.parse("[0.1000000000000000000000000001]");
+    std::printf("eager: %s\n", doc.dump().c_str());
+}
@@ -0,0 +1,55 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+using json = microlife::json;
+
+namespace {
+// heap bytes held by the value parsed from text
+std::uint64_t footprint(const std::string& text) {
+    auto before = bench::stats();
+    json j;
+    j.parse(text);
+    auto after = bench::stats();
+    bench::do_not_optimize(j);
+    return after.bytes - before.bytes;
+}
+
+std::string make_numbers(std::size_t count) {
+    bench::random rng;
+    std::string out = "[";
+    char number[32];
+    for (std::size_t i = 0; i < count; i++) {
+        if (i != 0)
+            out += ',';
+        std::snprintf(number, sizeof(number), "%.6f", rng.real() * 1000.0);
+        out += number;
+    }
+    out += ']';
+    return out;
+}
+} // namespace
+
+// memory footprint of parsed values: large number arrays dominate it
+int main() {
+    std::printf("sizeof(json): %zu bytes\n", sizeof(json));
+
+    for (std::size_t count : {1000, 100000, 1000000}) {
+        auto text = make_numbers(count);
+        // includes the unused capacity left by vector growth
+        auto bytes = footprint(text);
+        std::printf("%zu numbers: %llu heap bytes, %.2f bytes/element\n",
+                    count, (unsigned long long)bytes,
+                    double(bytes) / double(count));
+
+        bench::run("parse number array", text.size(), [&] {
+            json j;
+            j.parse(text);
+            bench::do_not_optimize(j);
+        });
+    }
+
+    auto text = bench::make_document(16 * 1024 * 1024);
+    auto bytes = footprint(text);
+    std::printf("document %zu bytes: %llu heap bytes (%.2fx)\n", text.size(),
+                (unsigned long long)bytes, double(bytes) / double(text.size()));
+}
@@ -0,0 +1,99 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <cstring> // strchr
+
+using json = microlife::json;
+using lexer = microlife::detail::lexer<json>;
+using token_t = microlife::detail::token_t;
+
+namespace {
+// a JSON array of count numbers printed with format
+template <typename Generator>
+std::string make_numbers(std::size_t count, Generator&& g) {
+    std::string out = "[";
+    char buffer[64];
+    for (std::size_t i = 0; i < count; i++) {
+        if (i != 0)
+            out += ',';
+        g(buffer, sizeof(buffer));
+        out += buffer;
+    }
+    out += ']';
+    return out;
+}
+
+// the previous implementation: copy the lexeme into a std::string, strtod
+double sum_strtod(const std::string& doc) {
+    double sum = 0;
+    const char* p = doc.c_str() + 1;
+    while (*p != '\0' && *p != ']') {
+        const char* first = p;
+        while (*p != ',' && *p != ']')
+            p++;
+        sum += strtod(std::string(first, p).c_str(), nullptr);
+        p++;
+    }
+    return sum;
+}
+
+// the lexer, validation and conversion in one pass
+double sum_lexer(const std::string& doc) {
+    double sum = 0;
+    lexer lex;
+    lex.init(doc.begin(), doc.end());
+    for (token_t t = lex.scan(); t != token_t::end_of_input; t = lex.scan()) {
+        if (t == token_t::value_number)
+            sum += lex.get_number();
+    }
+    return sum;
+}
+} // namespace
+
+// number conversion: strtod on a temporary string versus number_parser
+int main() {
+    const std::size_t count = 1000000;
+    bench::random rng;
+
+    struct {
+        const char* name;
+        std::string doc;
+    } docs[] = {
+        {"integers", make_numbers(count,
+                                  [&](char* b, std::size_t n) {
+                                      std::snprintf(b, n, "%llu",
+                                                    (unsigned long long)(
+                                                        rng.next() >> 20));
+                                  })},
+        {"telemetry %.6f", make_numbers(count,
+                                        [&](char* b, std::size_t n) {
+                                            std::snprintf(b, n, "%.6f",
+                                                          rng.real() * 1000);
+                                        })},
+        {"geo %.7f", make_numbers(count,
+                                  [&](char* b, std::size_t n) {
+                                      std::snprintf(b, n, "%.7f",
+                                                    rng.real() * 360 - 180);
+                                  })},
+        {"doubles %.17g", make_numbers(count,
+                                       [&](char* b, std::size_t n) {
+                                           std::snprintf(b, n, "%.17g",
+                                                         rng.real() * 1e10);
+                                       })},
+    };
+
+    for (auto& d : docs) {
+        std::printf("%s: %zu bytes\n", d.name, d.doc.size());
+        bench::run("strtod + std::string", d.doc.size(), [&] {
+            bench::do_not_optimize(sum_strtod(d.doc));
+        });
+        bench::run("lexer (number_parser)", d.doc.size(), [&] {
+            bench::do_not_optimize(sum_lexer(d.doc));
+        });
+        bench::run("json::parse", d.doc.size(), [&] {
+            json j;
+            j.parse(d.doc);
+            bench::do_not_optimize(j);
+        });
+    }
+}
@@ -0,0 +1,80 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+using json = microlife::json;
+using compact_json = microlife::compact::json;
+using microlife::detail::number_span;
+using microlife::detail::simd;
+
+namespace {
+// a time series: one array of n numbers
+std::string make_series(std::size_t n) {
+    bench::random rng;
+    std::string out = "[";
+    char number[32];
+    for (std::size_t i = 0; i < n; i++) {
+        if (i != 0)
+            out += ',';
+        std::snprintf(number, sizeof(number), "%.2f",
+                      20 + rng.real() * 10);
+        out += number;
+    }
+    out += ']';
+    return out;
+}
+
+template <typename Json>
+void measure(const char* name, const std::string& text) {
+    auto before = bench::stats();
+    Json j;
+    j.parse(text);
+    auto after = bench::stats();
+    auto numbers = *j.numbers();
+    auto capacity =
+        j.template get<const typename Json::array_t&>().capacity();
+    std::printf("%s: %llu heap bytes allocated, %zu bytes/number in the "
+                "array, stride %zu\n",
+                name, (unsigned long long)(after.bytes - before.bytes),
+                capacity * sizeof(Json) / numbers.size(), numbers.stride());
+
+    const std::size_t bytes = numbers.size() * sizeof(double);
+    bench::run("  parse", text.size(), [&] {
+        Json k;
+        k.parse(text);
+        bench::do_not_optimize(k);
+    });
+    // through the basic_json API, one element at a time
+    bench::run("  sum, get<double>() loop", bytes, [&] {
+        double sum = 0;
+        for (const auto& i : j.template get<const typename Json::array_t&>())
+            sum += i.template get<double>();
+        bench::do_not_optimize(sum);
+    });
+    bench::run("  numbers() (homogeneity check)", bytes,
+               [&] { bench::do_not_optimize(j.numbers()->size()); });
+
+    const char* const levels[] = {"scalar", "sse2", "avx2"};
+    for (int l = 0; l <= int(simd::detect()); l++) {
+        auto f = number_span::functions(simd::level(l));
+        char label[64];
+        std::snprintf(label, sizeof(label), "  sum, %s", levels[l]);
+        bench::run(label, bytes, [&] {
+            bench::do_not_optimize(
+                f.sum(numbers.bytes(), numbers.size(), numbers.stride()));
+        });
+    }
+    bench::run("  min + max + mean", bytes, [&] {
+        bench::do_not_optimize(numbers.min() + numbers.max() +
+                               numbers.mean());
+    });
+}
+} // namespace
+
+// one array of 4M numbers: 16 byte nodes versus 8 byte (compact) nodes,
+// element-wise reads versus the vectorized number_span reductions
+int main() {
+    auto series = make_series(4 * 1024 * 1024);
+    std::printf("series: %zu bytes\n", series.size());
+    measure<json>("json", series);
+    measure<compact_json>("compact::json", series);
+}
@@ -0,0 +1,119 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+using json = microlife::json;
+using hybrid_json =
+    microlife::detail::basic_json<microlife::detail::hybrid_object_json_policy>;
+using ordered_json = microlife::ordered_json;
+
+namespace {
+// one object with count members
+std::string make_large_object(std::size_t count) {
+    std::string out = "{";
+    for (std::size_t i = 0; i < count; i++) {
+        if (i != 0)
+            out += ',';
+        out += "\"field_" + std::to_string(i * 7919 % 1000003) + "\":";
+        out += std::to_string(i);
+    }
+    out += '}';
+    return out;
+}
+
+// every key of every object below j, with its object
+template <typename Json>
+void collect_keys(
+    Json& j,
+    std::vector<std::pair<typename Json::object_t*, std::string>>& out) {
+    if (j.is_array()) {
+        for (auto& i : j.template get<typename Json::array_t&>())
+            collect_keys(i, out);
+    } else if (j.is_object()) {
+        auto& object = j.template get<typename Json::object_t&>();
+        for (auto& i : object) {
+            out.emplace_back(&object, std::string(i.first));
+            collect_keys(i.second, out);
+        }
+    }
+}
+
+template <typename Json>
+std::size_t count_values(Json& j) {
+    std::size_t ret = 1;
+    if (j.is_array()) {
+        for (auto& i : j.template get<typename Json::array_t&>())
+            ret += count_values(i);
+    } else if (j.is_object()) {
+        for (auto& i : j.template get<typename Json::object_t&>())
+            ret += count_values(i.second);
+    }
+    return ret;
+}
+
+template <typename Json>
+void measure(const char* name, const std::string& text) {
+    auto before = bench::stats();
+    Json j;
+    j.parse(text);
+    auto after = bench::stats();
+    std::printf("%s: %llu heap bytes (%.2fx the text)\n", name,
+                (unsigned long long)(after.bytes - before.bytes),
+                double(after.bytes - before.bytes) / double(text.size()));
+
+    bench::run("  parse", text.size(), [&] {
+        Json k;
+        k.parse(text);
+        bench::do_not_optimize(k);
+    });
+
+    std::vector<std::pair<typename Json::object_t*, std::string>> keys;
+    collect_keys(j, keys);
+    std::vector<typename Json::string_t> probes;
+    for (auto& i : keys)
+        probes.emplace_back(i.second.data(), i.second.size());
+    char name_buffer[64];
+    std::snprintf(name_buffer, sizeof(name_buffer), "  find (%zu keys)",
+                  keys.size());
+    bench::run(name_buffer, text.size(), [&] {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < keys.size(); i++)
+            found += keys[i].first->find(probes[i]) != keys[i].first->end();
+        bench::do_not_optimize(found);
+    });
+
+    // before std::less<>: every probe built a temporary string_t
+    bench::run("  find (temporary string_t)", text.size(), [&] {
+        std::size_t found = 0;
+        for (auto& i : keys)
+            found += i.first->find(typename Json::string_t(i.second)) !=
+                     i.first->end();
+        bench::do_not_optimize(found);
+    });
+    bench::run("  find (std::string_view)", text.size(), [&] {
+        std::size_t found = 0;
+        for (auto& i : keys)
+            found += i.first->find(std::string_view(i.second)) !=
+                     i.first->end();
+        bench::do_not_optimize(found);
+    });
+
+    bench::run("  iterate", text.size(),
+               [&] { bench::do_not_optimize(count_values(j)); });
+}
+} // namespace
+
+// std::map objects versus hybrid_object (flat vector + hash index) and
+// its insertion-ordered variant
+int main() {
+    auto records = bench::make_document(16 * 1024 * 1024);
+    std::printf("records, small objects: %zu bytes\n", records.size());
+    measure<json>("std::map", records);
+    measure<hybrid_json>("hybrid_object", records);
+    measure<ordered_json>("ordered_object", records);
+
+    auto large = make_large_object(50000);
+    std::printf("one object, 50000 members: %zu bytes\n", large.size());
+    measure<json>("std::map", large);
+    measure<hybrid_json>("hybrid_object", large);
+    measure<ordered_json>("ordered_object", large);
+}
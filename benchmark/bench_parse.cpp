@@ -0,0 +1,41 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+using json = microlife::json;
+
+namespace {
+// counts the values, the SAX path does not build a tree
+struct sax_counter {
+    std::size_t values = 0;
+
+    bool null() { return ++values; }
+    bool boolean(bool) { return ++values; }
+    bool number(double) { return ++values; }
+    bool string(std::string&) { return ++values; }
+    bool start_object() { return ++values; }
+    bool key(std::string&) { return true; }
+    bool end_object() { return true; }
+    bool start_array() { return ++values; }
+    bool end_array() { return true; }
+};
+} // namespace
+
+// time and allocations per MB when parsing large documents into a DOM
+int main() {
+    for (std::size_t size : {64u * 1024u, 1024u * 1024u, 16u * 1024u * 1024u}) {
+        const std::string doc = bench::make_document(size);
+        std::printf("document: %zu bytes\n", doc.size());
+
+        bench::run("basic_json::parse", doc.size(), [&] {
+            json j;
+            j.parse(doc);
+            bench::do_not_optimize(j);
+        });
+
+        bench::run("json::sax_parse (count)", doc.size(), [&] {
+            sax_counter sax;
+            json::sax_parse(doc, &sax);
+            bench::do_not_optimize(sax.values);
+        });
+    }
+}
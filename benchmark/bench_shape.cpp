@@ -0,0 +1,105 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <string_view> // string_view
+
+using json = microlife::json;
+using ordered_json = microlife::ordered_json;
+using interned_json = microlife::interned_json;
+using shaped_json = microlife::shaped_json;
+
+namespace {
+// an array of rows with the same keys, as returned by an API
+std::string make_rows(std::size_t target_bytes) {
+    bench::random rng;
+    const char* const states[] = {"open", "closed", "merged"};
+    std::string out = "[";
+    for (std::size_t id = 0; out.size() < target_bytes; id++) {
+        if (id != 0)
+            out += ',';
+        out += "{\"id\":";
+        out += std::to_string(id);
+        out += ",\"number\":";
+        out += std::to_string(rng.uniform(100000));
+        out += ",\"state\":\"";
+        out += states[rng.uniform(3)];
+        out += "\",\"author_association\":\"MEMBER\",\"comments\":";
+        out += std::to_string(rng.uniform(100));
+        out += ",\"draft\":";
+        out += rng.uniform(2) ? "true" : "false";
+        out += ",\"created_at\":\"2026-10-17T08:00:00Z\",\"labels\":[]}";
+    }
+    out += ']';
+    return out;
+}
+
+template <typename Json>
+std::size_t count_values(const Json& j) {
+    std::size_t ret = 1;
+    if (j.is_array()) {
+        for (const auto& i : j.template get<const typename Json::array_t&>())
+            ret += count_values(i);
+    } else if (j.is_object()) {
+        for (const auto& i : j.template get<const typename Json::object_t&>())
+            ret += count_values(i.second);
+    }
+    return ret;
+}
+
+// sum of the member "comments" of every row
+template <typename Json>
+double sum_comments(const Json& j) {
+    double ret = 0;
+    for (const auto& i : j.template get<const typename Json::array_t&>())
+        ret += i.at("comments").template get<double>();
+    return ret;
+}
+
+template <typename Json>
+void measure(const char* name, const std::string& text) {
+    auto before = bench::stats();
+    Json j;
+    j.parse(text);
+    auto after = bench::stats();
+    std::printf("%s: %llu allocations, %llu heap bytes (%.2fx the text)\n",
+                name, (unsigned long long)(after.count - before.count),
+                (unsigned long long)(after.bytes - before.bytes),
+                double(after.bytes - before.bytes) / double(text.size()));
+
+    bench::run("  parse", text.size(), [&] {
+        Json k;
+        k.parse(text);
+        bench::do_not_optimize(k);
+    });
+    bench::run("  dump", text.size(),
+               [&] { bench::do_not_optimize(j.dump()); });
+    bench::run("  iterate", text.size(),
+               [&] { bench::do_not_optimize(count_values(j)); });
+    bench::run("  lookup by string", text.size(),
+               [&] { bench::do_not_optimize(sum_comments(j)); });
+}
+} // namespace
+
+// rows of one shape: a std::map per row, a vector of interned keys per
+// row, and one shared shape for all rows
+int main() {
+    auto rows = make_rows(16 * 1024 * 1024);
+    std::printf("rows: %zu bytes\n", rows.size());
+    measure<json>("json", rows);
+    measure<ordered_json>("ordered_json", rows);
+    measure<interned_json>("interned_json", rows);
+    measure<shaped_json>("shaped_json", rows);
+
+    // a lookup that remembers the slot of the previous row's shape
+    shaped_json j;
+    j.parse(rows);
+    bench::run("  lookup by member_key", rows.size(), [&] {
+        microlife::detail::member_key comments("comments");
+        double sum = 0;
+        for (const auto& i : j.get<const shaped_json::array_t&>()) {
+            const auto& row = i.get<const shaped_json::object_t&>();
+            sum += row.find(comments)->second.get<double>();
+        }
+        bench::do_not_optimize(sum);
+    });
+}
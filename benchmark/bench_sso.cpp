@@ -0,0 +1,92 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <string_view> // string_view
+
+using json = microlife::json;
+using sso_json = microlife::sso::json;
+
+namespace {
+// an array of records with short enum-like values and ids
+std::string make_record_document(std::size_t target_bytes) {
+    bench::random rng;
+    const char* const states[] = {"active", "pending", "closed", "banned"};
+    const char* const regions[] = {"eu-west-1", "us-east-2", "ap-south-1"};
+    std::string out = "[";
+    for (std::size_t id = 0; out.size() < target_bytes; id++) {
+        if (id != 0)
+            out += ',';
+        out += "{\"id\":\"u";
+        out += std::to_string(rng.uniform(100000000));
+        out += "\",\"state\":\"";
+        out += states[rng.uniform(4)];
+        out += "\",\"region\":\"";
+        out += regions[rng.uniform(3)];
+        out += "\",\"tags\":[\"a\",\"bb\",\"ccc\"],\"comment\":\"created by "
+               "the nightly import job\"}";
+    }
+    out += ']';
+    return out;
+}
+
+// total length of every string below j
+template <typename Json>
+std::size_t string_bytes(Json& j) {
+    switch (j.type()) {
+    case Json::value_t::string:
+        return j.template get<std::string_view>().size();
+    case Json::value_t::array: {
+        std::size_t ret = 0;
+        for (auto& i : j.template get<typename Json::array_t&>())
+            ret += string_bytes(i);
+        return ret;
+    }
+    case Json::value_t::object: {
+        std::size_t ret = 0;
+        for (auto& i : j.template get<typename Json::object_t&>())
+            ret += string_bytes(i.second);
+        return ret;
+    }
+    default:
+        return 0;
+    }
+}
+
+template <typename Json>
+void measure(const char* name, const std::string& text) {
+    auto before = bench::stats();
+    Json j;
+    j.parse(text);
+    auto after = bench::stats();
+    std::printf("%s: %llu allocations, %llu heap bytes (%.2fx the text)\n",
+                name, (unsigned long long)(after.count - before.count),
+                (unsigned long long)(after.bytes - before.bytes),
+                double(after.bytes - before.bytes) / double(text.size()));
+
+    bench::run("  parse", text.size(), [&] {
+        Json k;
+        k.parse(text);
+        bench::do_not_optimize(k);
+    });
+    bench::run("  read strings (string_view)", text.size(), [&] {
+        bench::do_not_optimize(string_bytes(j));
+    });
+    bench::run("  copy", text.size(), [&] {
+        Json k = j;
+        bench::do_not_optimize(k);
+    });
+}
+} // namespace
+
+// heap strings (std::string per value) versus the small string layout
+int main() {
+    auto records = make_record_document(16 * 1024 * 1024);
+    std::printf("record document: %zu bytes\n", records.size());
+    measure<json>("json", records);
+    measure<sso_json>("sso::json", records);
+
+    auto mixed = bench::make_document(16 * 1024 * 1024);
+    std::printf("mixed document: %zu bytes\n", mixed.size());
+    measure<json>("json", mixed);
+    measure<sso_json>("sso::json", mixed);
+}
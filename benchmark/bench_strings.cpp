@@ -0,0 +1,67 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <cstring> // strlen
+
+using json = microlife::json;
+using lexer = microlife::detail::lexer<json>;
+using token_t = microlife::detail::token_t;
+
+namespace {
+// an array of log records: a few short keys, one long message
+std::string make_log_document(std::size_t target_bytes) {
+    bench::random rng;
+    const char* const words[] = {"request", "GET",  "/api/v1/users",
+                                 "200",     "took", "12.5ms",
+                                 "agent",   "curl", "upstream=ok"};
+    std::string out = "[";
+    while (out.size() < target_bytes) {
+        if (out.size() > 1)
+            out += ',';
+        out += "{\"level\":\"info\",\"service\":\"gateway\",\"message\":\"";
+        for (std::size_t n = 0; n < 300;) {
+            const char* w = words[rng.uniform(9)];
+            out += w;
+            n += std::strlen(w) + 1;
+            out += rng.uniform(50) == 0 ? "\\\" " : " ";
+        }
+        out += rng.uniform(4) == 0 ? "\\n\"}" : "\"}";
+    }
+    out += ']';
+    return out;
+}
+
+std::size_t count_strings(const std::string& doc) {
+    lexer lex;
+    lex.init(doc.begin(), doc.end());
+    std::size_t bytes = 0;
+    for (token_t t = lex.scan(); t != token_t::end_of_input; t = lex.scan()) {
+        if (t == token_t::value_string)
+            bytes += lex.get_string().size();
+    }
+    return bytes;
+}
+} // namespace
+
+// string-heavy documents: lexer and parser throughput
+int main() {
+    for (std::size_t size : {64 * 1024, 16 * 1024 * 1024}) {
+        auto doc = make_log_document(size);
+        std::printf("log document: %zu bytes\n", doc.size());
+        bench::run("lexer, strings only", doc.size(),
+                   [&] { bench::do_not_optimize(count_strings(doc)); });
+        bench::run("json::parse", doc.size(), [&] {
+            json j;
+            j.parse(doc);
+            bench::do_not_optimize(j);
+        });
+    }
+
+    auto doc = bench::make_document(16 * 1024 * 1024);
+    std::printf("mixed document: %zu bytes\n", doc.size());
+    bench::run("json::parse", doc.size(), [&] {
+        json j;
+        j.parse(doc);
+        bench::do_not_optimize(j);
+    });
+}
@@ -0,0 +1,99 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+#include "nlohmann/json.hpp"
+
+using json = microlife::json;
+using document = microlife::document;
+using structural_parser = microlife::structural_parser;
+using structural_index = microlife::detail::structural_index;
+using level = structural_index::level;
+
+namespace {
+// checks the input, stores nothing
+struct null_sax {
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool number(double) { return true; }
+    bool string(std::string&) { return true; }
+    bool start_object() { return true; }
+    bool key(std::string&) { return true; }
+    bool end_object() { return true; }
+    bool start_array() { return true; }
+    bool end_array() { return true; }
+};
+
+const char* level_name(level l) {
+    switch (l) {
+    case level::avx2:
+        return "  stage 1, avx2";
+    case level::sse2:
+        return "  stage 1, sse2";
+    default:
+        return "  stage 1, scalar";
+    }
+}
+} // namespace
+
+// the two stage parser (structural index, then values) against parser and
+// nlohmann::json on a large document
+int main() {
+    const std::string text = bench::make_document(64 * 1024 * 1024);
+    std::printf("document: %zu bytes\n", text.size());
+
+    std::printf("structural index\n");
+    structural_index index;
+    for (auto l : {level::scalar, level::sse2, level::avx2}) {
+        if (l > microlife::detail::simd::detect() ||
+            structural_index::classify_function_of(l) == nullptr)
+            continue;
+        bench::run(level_name(l), text.size(), [&] {
+            index.build(text.data(), text.data() + text.size(), l);
+            bench::do_not_optimize(index.size());
+        });
+    }
+    std::printf("  %zu tokens\n", index.size());
+
+    structural_parser p;
+    std::printf("validation\n");
+    bench::run("  json::sax_parse (null handler)", text.size(), [&] {
+        null_sax sax;
+        bench::do_not_optimize(json::sax_parse(text, &sax));
+    });
+    bench::run("  structural_parser::accept", text.size(),
+               [&] { bench::do_not_optimize(p.accept(text)); });
+    bench::run("  nlohmann::json::accept", text.size(), [&] {
+        bench::do_not_optimize(nlohmann::json::accept(text));
+    });
+
+    std::printf("DOM\n");
+    bench::run("  json::parse", text.size(), [&] {
+        json j;
+        j.parse(text);
+        bench::do_not_optimize(j);
+    });
+    bench::run("  structural_parser::parse", text.size(), [&] {
+        json j;
+        p.parse(text, j);
+        bench::do_not_optimize(j);
+    });
+    bench::run("  nlohmann::json::parse", text.size(), [&] {
+        auto j = nlohmann::json::parse(text);
+        bench::do_not_optimize(j);
+    });
+
+    document doc;
+    document::parse_options structural;
+    structural.structural = true;
+    bench::run("  document::parse", text.size(), [&] {
+        doc.parse(text);
+        bench::do_not_optimize(doc.root());
+    });
+    bench::run("  document::parse, structural", text.size(), [&] {
+        doc.parse(text, structural);
+        bench::do_not_optimize(doc.root());
+    });
+    bench::run("  document::borrow, structural", text.size(), [&] {
+        doc.borrow(text, structural);
+        bench::do_not_optimize(doc.root());
+    });
+}
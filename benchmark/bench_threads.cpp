@@ -0,0 +1,44 @@
+#include "bench.hpp"
+#include "microlife/json.hpp"
+
+#include <atomic> // atomic
+#include <thread> // thread
+
+using json = microlife::json;
+
+// throughput of basic_json::parse from 1 to N threads
+int main() {
+    const std::string doc = bench::make_document(1024 * 1024);
+    const int rounds = 20;
+    unsigned max_threads = std::thread::hardware_concurrency();
+    if (max_threads < 4)
+        max_threads = 4;
+
+    std::printf("document: %zu bytes, %d parses per thread\n", doc.size(),
+                rounds);
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        std::atomic<int> failed{0};
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([&] {
+                for (int i = 0; i < rounds; i++) {
+                    json j;
+                    if (!j.parse(doc))
+                        failed++;
+                    bench::do_not_optimize(j);
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+
+        double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        double mb = double(doc.size()) * rounds * threads / (1024.0 * 1024.0);
+        std::printf("%2u threads %10.3f s  %9.2f MB/s total%s\n", threads,
+                    seconds, mb / seconds, failed ? "  (parse failed)" : "");
+    }
+}
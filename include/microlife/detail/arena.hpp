@@ -0,0 +1,153 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+
+#include <cstddef>         // size_t, max_align_t
+#include <cstdint>         // uintptr_t
+#include <cstring>         // memcpy
+#include <memory_resource> // memory_resource
+#include <new>             // operator new
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief monotonic arena
+ * @details Hands out memory from large chunks by bumping a pointer,
+ * deallocate() does nothing. Everything is released at once by reset() or
+ * by the destructor. reset() keeps the memory: when several chunks were
+ * used they are replaced by a single chunk of their total size, so the
+ * next document of a similar size is built without any heap allocation.
+ * Derives from std::pmr::memory_resource, so std::pmr containers can
+ * allocate from it. Not thread-safe.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class arena : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t initial_chunk_size = 4096;
+    static constexpr std::size_t max_chunk_size = std::size_t(1) << 24;
+
+private:
+    // header at the beginning of every chunk
+    struct chunk {
+        chunk* next;      // the previous chunk
+        std::size_t size; // including the header
+    };
+
+    chunk* m_chunks = nullptr; // the current chunk, the older ones follow
+    char* m_cur = nullptr;     // the first free byte of the current chunk
+    char* m_end = nullptr;
+    std::size_t m_used = 0;           // bytes handed out since reset()
+    std::size_t m_next_chunk_size = initial_chunk_size;
+
+public:
+    arena() = default;
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+    ~arena() override { release(); }
+
+    // like allocate(), without the virtual call
+    void* allocate_bytes(std::size_t bytes,
+                         std::size_t alignment = alignof(std::max_align_t)) {
+        json_assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        auto p = align_up(m_cur, alignment);
+        if (p == nullptr || p > m_end || bytes > std::size_t(m_end - p)) {
+            add_chunk(bytes + alignment);
+            p = align_up(m_cur, alignment);
+        }
+        m_cur = p + bytes;
+        m_used += bytes;
+        return p;
+    }
+
+    // n objects of T, not constructed
+    template <typename T>
+    T* allocate_array(std::size_t n) {
+        return static_cast<T*>(allocate_bytes(n * sizeof(T), alignof(T)));
+    }
+
+    // copy of [str, str + len) followed by a null byte
+    const char* copy_string(const char* str, std::size_t len) {
+        auto p = static_cast<char*>(allocate_bytes(len + 1, 1));
+        std::memcpy(p, str, len);
+        p[len] = '\0';
+        return p;
+    }
+
+    // free everything that was handed out, keep the memory
+    void reset() {
+        if (m_chunks != nullptr && m_chunks->next != nullptr) {
+            // merge the chunks into one for the next round
+            std::size_t total = 0;
+            for (chunk* c = m_chunks; c != nullptr; c = c->next)
+                total += c->size;
+            release();
+            m_next_chunk_size = total;
+            add_chunk(0);
+        }
+        if (m_chunks != nullptr) {
+            m_cur = reinterpret_cast<char*>(m_chunks + 1);
+            m_end = reinterpret_cast<char*>(m_chunks) + m_chunks->size;
+        }
+        m_used = 0;
+    }
+
+    // free everything and return the memory to the heap
+    void release() {
+        for (chunk* c = m_chunks; c != nullptr;) {
+            chunk* next = c->next;
+            ::operator delete(c);
+            c = next;
+        }
+        m_chunks = nullptr;
+        m_cur = m_end = nullptr;
+        m_used = 0;
+        m_next_chunk_size = initial_chunk_size;
+    }
+
+    // bytes handed out since the last reset()
+    std::size_t used() const { return m_used; }
+
+    // bytes of all chunks
+    std::size_t capacity() const {
+        std::size_t total = 0;
+        for (chunk* c = m_chunks; c != nullptr; c = c->next)
+            total += c->size;
+        return total;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return allocate_bytes(bytes, alignment);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const
+        noexcept override {
+        return this == &other;
+    }
+
+private:
+    static char* align_up(char* p, std::size_t alignment) {
+        auto n = reinterpret_cast<std::uintptr_t>(p);
+        return reinterpret_cast<char*>((n + alignment - 1) & ~(alignment - 1));
+    }
+
+    // a new current chunk with at least min_bytes free
+    void add_chunk(std::size_t min_bytes) {
+        std::size_t size = m_next_chunk_size;
+        if (size < min_bytes + sizeof(chunk))
+            size = min_bytes + sizeof(chunk);
+        if (m_next_chunk_size < max_chunk_size)
+            m_next_chunk_size *= 2;
+
+        auto c = static_cast<chunk*>(::operator new(size));
+        c->next = m_chunks;
+        c->size = size;
+        m_chunks = c;
+        m_cur = reinterpret_cast<char*>(c + 1);
+        m_end = reinterpret_cast<char*>(c) + size;
+    }
+};
+} // namespace detail
+} // namespace microlife
@@ -1,38 +1,145 @@
 #pragma once
+#include "input_adapter.hpp"
+#include "json_policy.hpp"
+#include "json_storage.hpp"
 #include "lexer.hpp"
-#include "macro_scope.hpp"
 #include "macro_scope.hpp" // json_assert()
+#include "number_span.hpp"
+#include "number_value.hpp"
+#include "output_adapter.hpp"
 #include "parser.hpp"
+#include "parser_pool.hpp"
+#include "serializer.hpp"
 #include "value_t.hpp"
 
-#include <algorithm> // sort
-#include <map>       // object_t
-#include <sstream>   // ostringstream
-#include <string.h>  // strcmp
-#include <string>    // string_t
-#include <vector>    // vector_t
+#include <algorithm>   // sort
+#include <cstdint>     // uint64_t
+#include <cstdio>      // FILE
+#include <cstring>     // memcpy
+#include <limits>      // numeric_limits
+#include <memory>      // allocator_traits
+#include <optional>    // optional
+#include <ostream>     // ostream
+#include <string>      // string
+#include <string_view> // string_view
+#include <type_traits> // enable_if, is_integral, is_same, void_t
+#include <utility>     // pair
+#include <vector>      // vector
 
 namespace microlife {
 namespace detail {
+// object_t keeps its keys sorted (has a key_compare, e.g. std::map)
+template <typename ObjectType, typename = void>
+struct is_sorted_object : std::false_type {};
+
+template <typename ObjectType>
+struct is_sorted_object<ObjectType,
+                        std::void_t<typename ObjectType::key_compare>>
+    : std::true_type {};
+
 /***
  * @brief Basic JSON class
  * @details This class is used to store JSON data.
+ * The value types and the allocator come from Policy (see json_policy.hpp).
+ * Strings, arrays and objects are allocated with allocator_type, which is
+ * passed on to the containers, so with pmr_json_policy a whole tree lives
+ * in one std::pmr::memory_resource.
  * @author qingl
  * @date 2022_04_14
  */
-class basic_json {
+template <typename Policy = ::microlife::detail::json_policy>
+class basic_json : private ::microlife::detail::allocator_holder<
+                       typename Policy::allocator_type> {
 public:
-    using boolean_t = bool;
-    using number_t = double;
-    using string_t = std::string;
-    using array_t = std::vector<basic_json>;
-    using object_t = std::map<string_t, basic_json>;
+    using policy_type = Policy;
+
+    using boolean_t = typename Policy::boolean_t;
+    using number_t = typename Policy::number_t;
+    using number_integer_t = typename Policy::number_integer_t;
+    using number_unsigned_t = typename Policy::number_unsigned_t;
+    using string_t = typename Policy::string_t;
+    using array_t = typename Policy::template array_t<basic_json>;
+    using object_t = typename Policy::template object_t<basic_json>;
+
+    using allocator_type = typename Policy::allocator_type;
 
     using value_t = detail::value_t;
 
 private:
+    using allocator_base =
+        ::microlife::detail::allocator_holder<allocator_type>;
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
     using parser =
         ::microlife::detail::parser<::microlife::detail::lexer, basic_json>;
+    using parser_pool = ::microlife::detail::parser_pool<parser>;
+
+    template <typename, typename>
+    friend class ::microlife::detail::serializer;
+
+    // allocate a T with alloc and construct it from args
+    // containers receive alloc as well (uses-allocator construction)
+    template <typename T, typename... Args>
+    static T* create(const allocator_type& alloc, Args&&... args) {
+        using traits = typename allocator_traits::template rebind_traits<T>;
+        typename traits::allocator_type a(alloc);
+        T* p = traits::allocate(a, 1);
+        try {
+            traits::construct(a, p, std::forward<Args>(args)...);
+        } catch (...) {
+            traits::deallocate(a, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    // destroy and free a T made by create()
+    template <typename T>
+    static void dispose(const allocator_type& alloc, T* p) {
+        using traits = typename allocator_traits::template rebind_traits<T>;
+        typename traits::allocator_type a(alloc);
+        traits::destroy(a, p);
+        traits::deallocate(a, p, 1);
+    }
+
+    // small_strings: a string value is a string_buffer, see json_policy
+    static constexpr bool small_strings = Policy::small_strings;
+    using string_pointer =
+        std::conditional_t<small_strings, ::microlife::detail::string_buffer*,
+                           string_t*>;
+
+    // allocate a string value holding str
+    template <typename StringType>
+    static string_pointer create_string(const allocator_type& alloc,
+                                        StringType&& str) {
+        if constexpr (small_strings) {
+            using buffer = ::microlife::detail::string_buffer;
+            using traits =
+                typename allocator_traits::template rebind_traits<buffer>;
+            typename traits::allocator_type a(alloc);
+
+            std::string_view view(str);
+            buffer* p = traits::allocate(a, buffer::units(view.size()));
+            p->size = view.size();
+            std::memcpy(p->data(), view.data(), view.size());
+            return p;
+        } else {
+            return create<string_t>(alloc, std::forward<StringType>(str));
+        }
+    }
+
+    // free a string value made by create_string()
+    static void dispose_string(const allocator_type& alloc, string_pointer p) {
+        if constexpr (small_strings) {
+            using buffer = ::microlife::detail::string_buffer;
+            using traits =
+                typename allocator_traits::template rebind_traits<buffer>;
+            typename traits::allocator_type a(alloc);
+            traits::deallocate(a, p, buffer::units(p->size));
+        } else {
+            dispose(alloc, p);
+        }
+    }
 
     // private
     JSON_PRIVATE_UNLESS_TESTED
@@ -46,7 +153,9 @@ private:
     union json_value {
         boolean_t boolean;
         number_t number;
-        string_t* string;
+        number_integer_t integer;
+        number_unsigned_t unsigned_integer;
+        string_pointer string;
         array_t* array;
         object_t* object;
 
@@ -55,28 +164,42 @@ private:
         json_value() = default;
         json_value(boolean_t v) noexcept : boolean(v) {}
         json_value(number_t v) noexcept : number(v) {}
-        json_value(int v) noexcept : number(v) {}
-
-        json_value(const string_t& value) : string(new string_t(value)) {}
-        json_value(const object_t& value) : object(new object_t(value)) {}
-        json_value(const array_t& value) : array(new array_t(value)) {}
-
-        json_value(string_t&& value) : string(new string_t(std::move(value))) {}
-        json_value(object_t&& value) : object(new object_t(std::move(value))) {}
-        json_value(array_t&& value) : array(new array_t(std::move(value))) {}
-
-        json_value(value_t t) {
+        json_value(number_integer_t v) noexcept : integer(v) {}
+        json_value(number_unsigned_t v) noexcept : unsigned_integer(v) {}
+        json_value(int v) noexcept : integer(v) {}
+
+        json_value(const string_t& value,
+                   const allocator_type& alloc = allocator_type())
+            : string(create_string(alloc, value)) {}
+        json_value(const object_t& value,
+                   const allocator_type& alloc = allocator_type())
+            : object(create<object_t>(alloc, value)) {}
+        json_value(const array_t& value,
+                   const allocator_type& alloc = allocator_type())
+            : array(create<array_t>(alloc, value)) {}
+
+        json_value(string_t&& value,
+                   const allocator_type& alloc = allocator_type())
+            : string(create_string(alloc, std::move(value))) {}
+        json_value(object_t&& value,
+                   const allocator_type& alloc = allocator_type())
+            : object(create<object_t>(alloc, std::move(value))) {}
+        json_value(array_t&& value,
+                   const allocator_type& alloc = allocator_type())
+            : array(create<array_t>(alloc, std::move(value))) {}
+
+        json_value(value_t t, const allocator_type& alloc = allocator_type()) {
             switch (t) {
             case value_t::object:
-                object = new object_t();
+                object = create<object_t>(alloc);
                 break;
 
             case value_t::array:
-                array = new array_t();
+                array = create<array_t>(alloc);
                 break;
 
             case value_t::string:
-                string = new string_t();
+                string = create_string(alloc, std::string_view());
                 break;
 
             case value_t::boolean:
@@ -87,6 +210,14 @@ private:
                 number = number_t(0);
                 break;
 
+            case value_t::number_integer:
+                integer = 0;
+                break;
+
+            case value_t::number_unsigned:
+                unsigned_integer = 0;
+                break;
+
             default:
             case value_t::null:
                 object = nullptr;
@@ -95,74 +226,142 @@ private:
         }
 
         // TODO: 改为非递归版本
-        void destroy(const value_t t) {
+        // alloc must be the allocator the value was created with
+        void destroy(const value_t t,
+                     const allocator_type& alloc = allocator_type()) {
             if (t == value_t::array) {
-                delete array;
+                dispose(alloc, array);
             } else if (t == value_t::object) {
-                delete object;
+                dispose(alloc, object);
             } else if (t == value_t::string) {
-                delete string;
+                dispose_string(alloc, string);
             }
         }
     };
 
 private:
-    value_t m_type;
-    json_value m_value;
+    // type + value, the layout is chosen by the policy (json_storage.hpp)
+    using storage_t = typename Policy::template storage_t<json_value>;
+    storage_t m_data;
+
+    static_assert(small_strings || storage_t::inline_capacity == 0,
+                  "inline strings require Policy::small_strings");
 
 public:
     // 基本构造函数
-    basic_json(std::nullptr_t = nullptr) : m_type(value_t::null), m_value() {}
-    basic_json(boolean_t v) : m_type(value_t::boolean), m_value(v) {}
-    basic_json(number_t v) : m_type(value_t::number), m_value(v) {}
-    basic_json(int v) : m_type(value_t::number), m_value(v) {}
-    basic_json(const char* v)
-        : m_type(value_t::string), m_value(std::move(string_t(v))) {}
+    basic_json(std::nullptr_t = nullptr,
+               const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc), m_data(value_t::null, json_value()) {}
+    explicit basic_json(const allocator_type& alloc)
+        : allocator_base(alloc), m_data(value_t::null, json_value()) {}
+    // only bool itself, a pointer must not become a boolean
+    template <typename BooleanType,
+              std::enable_if_t<std::is_same_v<BooleanType, boolean_t>, int> = 0>
+    basic_json(BooleanType v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc), m_data(value_t::boolean, json_value(v)) {}
+    basic_json(number_t v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc), m_data(value_t::number, json_value(v)) {}
+    // any integer type: number_integer, or number_unsigned above INT64_MAX
+    template <typename IntegerType,
+              std::enable_if_t<std::is_integral_v<IntegerType> &&
+                                   !std::is_same_v<IntegerType, bool>,
+                               int> = 0>
+    basic_json(IntegerType v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc), m_data(make_integer(v, alloc)) {}
+    basic_json(const char* v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc),
+          m_data(make_string(std::string_view(v), alloc)) {}
 
     // 拷贝构造函数
-    basic_json(const string_t& v) : m_type(value_t::string), m_value(v) {}
-    basic_json(const array_t& v) : m_type(value_t::array), m_value(v) {}
-    basic_json(const object_t& v) : m_type(value_t::object), m_value(v) {}
+    basic_json(const string_t& v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc),
+          m_data(make_string(v, alloc)) {}
+    basic_json(const array_t& v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc), m_data(value_t::array, json_value(v, alloc)) {}
+    basic_json(const object_t& v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc),
+          m_data(value_t::object, json_value(v, alloc)) {}
 
     // 移动构造函数
-    basic_json(string_t&& v) : m_type(value_t::string), m_value(std::move(v)) {}
-    basic_json(array_t&& v) : m_type(value_t::array), m_value(std::move(v)) {}
-    basic_json(object_t&& v) : m_type(value_t::object), m_value(std::move(v)) {}
+    basic_json(string_t&& v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc),
+          m_data(make_string(std::move(v), alloc)) {}
+    basic_json(array_t&& v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc),
+          m_data(value_t::array, json_value(std::move(v), alloc)) {}
+    basic_json(object_t&& v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc),
+          m_data(value_t::object, json_value(std::move(v), alloc)) {}
 
     // 按类型构造 basic_json
-    basic_json(value_t v) : m_type(v), m_value(v) {}
+    basic_json(value_t v, const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc),
+          m_data(v == value_t::string ? make_string(std::string_view(), alloc)
+                                      : storage_t(v, json_value(v, alloc))) {}
 
     // 构造函数
+    // a copy gets the allocator chosen by the allocator for copies
+    // (std::pmr: the default resource), or the given one
     basic_json(const basic_json& v)
-        : m_type(v.m_type), m_value(v.deep_copy()) {}
+        : basic_json(v, allocator_traits::select_on_container_copy_construction(
+                            v.get_allocator())) {}
 
-    basic_json(basic_json&& other) noexcept {
-        m_type = other.m_type;
-        m_value = other.m_value;
+    basic_json(const basic_json& v, const allocator_type& alloc)
+        : allocator_base(alloc), m_data(v.deep_copy(alloc)) {}
 
-        other.m_type = value_t::null;
+    // the allocator moves with the value
+    basic_json(basic_json&& other) noexcept
+        : allocator_base(other.get_allocator()), m_data(other.m_data) {
+        other.m_data = storage_t();
     }
 
-    basic_json(size_t cnt, const basic_json& val)
-        : m_type(value_t::array), m_value(value_t::array) {
+    // steals the value if both allocators are equal, copies it otherwise
+    basic_json(basic_json&& other, const allocator_type& alloc)
+        : allocator_base(alloc) {
+        if (alloc == other.get_allocator()) {
+            m_data = other.m_data;
+            other.m_data = storage_t();
+        } else {
+            m_data = other.deep_copy(alloc);
+        }
+    }
+
+    basic_json(size_t cnt, const basic_json& val,
+               const allocator_type& alloc = allocator_type())
+        : allocator_base(alloc),
+          m_data(value_t::array, json_value(value_t::array, alloc)) {
         while (cnt--) {
-            m_value.array->push_back(val);
+            m_data.value().array->push_back(val);
         }
     }
 
     // 析构函数
-    virtual ~basic_json() { m_value.destroy(m_type); }
+    // 非虚: 每个节点 (包括数组元素) 不带 vptr, 不要通过基类指针删除
+    ~basic_json() { destroy(); }
+
+    using allocator_base::get_allocator;
 
 public:
-    value_t type() const { return m_type; }
+    value_t type() const { return m_data.type(); }
 
     // is_type() ?
-    bool is_null() const { return m_type == value_t::null; }
-    bool is_boolean() const { return m_type == value_t::boolean; }
-    bool is_number() const { return m_type == value_t::number; }
-    bool is_string() const { return m_type == value_t::string; }
-    bool is_array() const { return m_type == value_t::array; }
-    bool is_object() const { return m_type == value_t::object; }
+    bool is_null() const { return type() == value_t::null; }
+    bool is_boolean() const { return type() == value_t::boolean; }
+    // a number of any kind
+    bool is_number() const {
+        return is_number_float() || is_number_integer() ||
+               is_number_unsigned();
+    }
+    bool is_number_float() const { return type() == value_t::number; }
+    bool is_number_integer() const {
+        return type() == value_t::number_integer;
+    }
+    bool is_number_unsigned() const {
+        return type() == value_t::number_unsigned;
+    }
+    bool is_string() const { return type() == value_t::string; }
+    bool is_array() const { return type() == value_t::array; }
+    bool is_object() const { return type() == value_t::object; }
 
     // T get<T>()
     template <typename T>
@@ -170,68 +369,84 @@ public:
         // bool
         if constexpr (std::is_same_v<T, bool>) {
             json_assert(is_boolean());
-            return m_value.boolean;
+            return m_data.value().boolean;
         }
-        // int
-        else if constexpr (std::is_same_v<T, int>) {
+        // int, std::int64_t, std::uint64_t ..., from a number of any kind
+        // the value must be in the range of T, a float is truncated
+        else if constexpr (std::is_integral_v<T>) {
             json_assert(is_number());
-            return static_cast<int>(m_value.number);
+            const auto n = number_value();
+            json_assert(n.template fits<T>());
+            return n.template to<T>();
         }
-        // double
-        else if constexpr (std::is_same_v<T, double>) {
+        // double, float
+        else if constexpr (std::is_floating_point_v<T>) {
             json_assert(is_number());
-            return m_value.number;
+            return number_value().template to<T>();
         }
 
         // string
-        else if constexpr (std::is_same_v<T, std::string>) {
+        else if constexpr (std::is_same_v<T, string_t>) {
             json_assert(is_string());
-            return *m_value.string;
+            if constexpr (small_strings) {
+                auto str = string_view();
+                return string_t(str.data(), str.size());
+            } else {
+                return *m_data.value().string;
+            }
         }
-        // string&
-        else if constexpr (std::is_same_v<T, std::string&>) {
+        // string&, const string&
+        // small_strings: there is no string_t object, use std::string_view
+        else if constexpr (std::is_same_v<T, string_t&> ||
+                           std::is_same_v<T, const string_t&>) {
+            static_assert(!small_strings,
+                          "basic_json::get<T>() : use get<std::string_view>()"
+                          " with Policy::small_strings");
             json_assert(is_string());
-            return *m_value.string;
+            return *m_data.value().string;
         }
-        // const string&
-        else if constexpr (std::is_same_v<T, const std::string&>) {
+        // std::string, when string_t is another type (e.g. std::pmr::string)
+        else if constexpr (std::is_same_v<T, std::string>) {
             json_assert(is_string());
-            return *m_value.string;
+            auto str = string_view();
+            return std::string(str.data(), str.size());
+        }
+        // std::string_view, valid until the value is changed or destroyed
+        else if constexpr (std::is_same_v<T, std::string_view>) {
+            json_assert(is_string());
+            return string_view();
         }
 
-        // vector<basic_json>
-        else if constexpr (std::is_same_v<T, std::vector<basic_json>>) {
+        // array_t
+        else if constexpr (std::is_same_v<T, array_t>) {
             json_assert(is_array());
-            return *m_value.array;
+            return *m_data.value().array;
         }
-        // vector<basic_json>&
-        else if constexpr (std::is_same_v<T, std::vector<basic_json>&>) {
+        // array_t&
+        else if constexpr (std::is_same_v<T, array_t&>) {
             json_assert(is_array());
-            return *m_value.array;
+            return *m_data.value().array;
         }
-        // const vector<basic_json>&
-        else if constexpr (std::is_same_v<T, const std::vector<basic_json>&>) {
+        // const array_t&
+        else if constexpr (std::is_same_v<T, const array_t&>) {
             json_assert(is_array());
-            return *m_value.array;
+            return *m_data.value().array;
         }
 
-        // map<string, basic_json>
-        else if constexpr (std::is_same_v<T,
-                                          std::map<std::string, basic_json>>) {
+        // object_t
+        else if constexpr (std::is_same_v<T, object_t>) {
             json_assert(is_object());
-            return *m_value.object;
+            return *m_data.value().object;
         }
-        // map<string, basic_json>&
-        else if constexpr (std::is_same_v<T,
-                                          std::map<std::string, basic_json>&>) {
+        // object_t&
+        else if constexpr (std::is_same_v<T, object_t&>) {
             json_assert(is_object());
-            return *m_value.object;
+            return *m_data.value().object;
         }
-        // const map<string, basic_json>&
-        else if constexpr (std::is_same_v<
-                               T, const std::map<std::string, basic_json>&>) {
+        // const object_t&
+        else if constexpr (std::is_same_v<T, const object_t&>) {
             json_assert(is_object());
-            return *m_value.object;
+            return *m_data.value().object;
         }
 
         // else
@@ -241,82 +456,207 @@ public:
         }
     }
 
-    // TODO: 改为非递归版本
+    // T get<T>() const, T is a value or a const reference
+    template <typename T>
+    T get() const {
+        static_assert(!std::is_reference_v<T> ||
+                          std::is_const_v<std::remove_reference_t<T>>,
+                      "basic_json::get<T>() const : T must not be a "
+                      "non-const reference");
+        // get<T>() does not modify *this for these T
+        return const_cast<basic_json*>(this)->template get<T>();
+    }
+
+    // 对象成员访问, key 以 std::string_view 查找, 不构造临时 string_t
+
+    // the member named key, nullptr if there is none (or not an object)
+    basic_json* find(std::string_view key) {
+        if (!is_object())
+            return nullptr;
+        auto* object = m_data.value().object;
+        auto it = object->find(key);
+        return it == object->end() ? nullptr : &it->second;
+    }
+    const basic_json* find(std::string_view key) const {
+        return const_cast<basic_json*>(this)->find(key);
+    }
+
+    bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+    // the member named key, which must exist
+    basic_json& at(std::string_view key) {
+        basic_json* ret = find(key);
+        json_assert(ret != nullptr);
+        return *ret;
+    }
+    const basic_json& at(std::string_view key) const {
+        const basic_json* ret = find(key);
+        json_assert(ret != nullptr);
+        return *ret;
+    }
+
+    // the member named key, inserted as null if missing
+    // a null value becomes an empty object first
+    basic_json& operator[](std::string_view key) {
+        if (is_null())
+            *this = basic_json(value_t::object, get_allocator());
+        json_assert(is_object());
+        if (basic_json* ret = find(key))
+            return *ret;
+        auto* object = m_data.value().object;
+        using key_type = typename object_t::key_type;
+        return object->emplace(key_type(key), nullptr).first->second;
+    }
+
+    // the element at index of an array
+    basic_json& operator[](std::size_t index) {
+        json_assert(is_array() && index < m_data.value().array->size());
+        return (*m_data.value().array)[index];
+    }
+    const basic_json& operator[](std::size_t index) const {
+        return (*const_cast<basic_json*>(this))[index];
+    }
+
+    // the elements of an array of numbers, read in place (no copy), with
+    // vectorized sum/min/max/mean, see number_span
+    // std::nullopt if this is not an array or holds a value that is not a
+    // number; an array of doubles is read in place (compact::json gives a
+    // contiguous double buffer), integers are converted when read
+    std::optional<::microlife::detail::number_span> numbers() const {
+        static_assert(std::is_same_v<number_t, double>,
+                      "number_span reads number_t as double");
+        using span = ::microlife::detail::number_span;
+        if (!is_array())
+            return std::nullopt;
+        const auto& array = *m_data.value().array;
+        bool floats = true;
+        for (const auto& i : array) {
+            if (!i.is_number())
+                return std::nullopt;
+            floats = floats && i.is_number_float();
+        }
+        if (array.empty())
+            return span();
+        if (floats)
+            return span(array.front().m_data.number_bytes(), array.size(),
+                        sizeof(basic_json));
+        return span(reinterpret_cast<const unsigned char*>(array.data()),
+                    array.size(), sizeof(basic_json), &number_at);
+    }
+
+    // get<T>() of the member named key, default_value if there is none
+    template <typename T>
+    T value(std::string_view key, const T& default_value) const {
+        const basic_json* ret = find(key);
+        return ret == nullptr ? default_value : ret->template get<T>();
+    }
+    string_t value(std::string_view key, const char* default_value) const {
+        const basic_json* ret = find(key);
+        return ret == nullptr ? string_t(default_value)
+                              : ret->template get<string_t>();
+    }
+
     // get a string representation of a JSON value (serialize)
     string_t dump() const {
-        switch ((m_type)) {
-        default:
-        case value_t::null:
-            return "null";
+        string_t ret;
+        dump(ret);
+        return ret;
+    }
 
-        case value_t::boolean:
-            if (m_value.boolean)
-                return "true";
-            else
-                return "false";
+    // append the serialization to str
+    void dump(string_t& str) const {
+        auto out = ::microlife::detail::output_adapter(str);
+        dump_to(out);
+    }
 
-        case value_t::number:
-            return number_to_dump(m_value.number);
+    // write the serialization to a stream
+    void dump(std::ostream& os) const {
+        auto out = ::microlife::detail::output_adapter(os);
+        dump_to(out);
+    }
 
-        case value_t::string:
-            return string_to_dump(*m_value.string);
+    // write the serialization to a C file, the file is not flushed
+    void dump(std::FILE* file) const {
+        auto out = ::microlife::detail::output_adapter(file);
+        dump_to(out);
+    }
 
-        case value_t::array: {
-            string_t ret;
-            ret.push_back('[');
-            if (m_value.array->size() > 0) {
-                for (auto& i : *m_value.array) {
-                    ret += i.dump();
-                    ret.push_back(',');
-                }
-                ret.pop_back();
-            }
-            ret.push_back(']');
-            return ret;
-        }
+    // write at most size characters to buffer, no null byte is added
+    // returns the length of the whole serialization, like snprintf
+    std::size_t dump(char* buffer, std::size_t size) const {
+        auto out = ::microlife::detail::output_adapter(buffer, size);
+        dump_to(out);
+        return out.size();
+    }
 
-        case value_t::object: {
-            string_t ret;
-            ret.push_back('{');
-            if (m_value.object->size() > 0) {
-                for (const auto& i : *m_value.object) {
-                    ret += '\"' + i.first + '\"' + ':';
-                    ret += i.second.dump();
-                    ret.push_back(',');
-                }
-                ret.pop_back();
-            }
-            ret.push_back('}');
-            return ret;
-        }
-        }
+    // write the serialization to any output adapter (see output_adapter.hpp)
+    // e.g. fd_output_adapter
+    template <typename OutputAdapterType>
+    void dump_to(OutputAdapterType& output) const {
+        ::microlife::detail::serializer<basic_json, OutputAdapterType> s(
+            output);
+        s.dump(*this);
     }
 
     // parse a string into a JSON value (deserialize)
-    bool parse(const string_t& str) {
-        static parser p;
-        return p.parse(str, *this);
+    // input: std::string, std::string_view, const char*, std::vector<char>,
+    // or anything else accepted by input_adapter()
+    // thread-safe, the parser is borrowed from a per-thread pool
+    template <typename InputType>
+    bool parse(InputType&& input) {
+        auto p = parser_pool::acquire();
+        return p->parse(std::forward<InputType>(input), *this);
+    }
+
+    // parse [first, last), contiguous ranges are not copied
+    template <typename IteratorType>
+    bool parse(IteratorType first, IteratorType last) {
+        return parse(::microlife::detail::input_adapter(first, last));
+    }
+
+    // parse len characters starting at str
+    bool parse(const char* str, std::size_t len) {
+        return parse(::microlife::detail::input_adapter(str, len));
+    }
+
+    // parse the input and report every value to a SAX handler
+    // see json_sax.hpp for the required member functions
+    template <typename InputType, typename SAX>
+    static bool sax_parse(InputType&& input, SAX* sax) {
+        auto p = parser_pool::acquire();
+        return p->sax_parse(std::forward<InputType>(input), sax);
+    }
+
+    template <typename IteratorType, typename SAX>
+    static bool sax_parse(IteratorType first, IteratorType last, SAX* sax) {
+        return sax_parse(::microlife::detail::input_adapter(first, last), sax);
     }
 
 public:
     // 赋值函数
+    // the allocator of *this is kept, the value is copied into it
     basic_json& operator=(const basic_json& other) {
-        m_value.destroy(m_type);
+        storage_t copy = other.deep_copy(get_allocator());
+        destroy();
 
-        m_type = other.m_type;
-        m_value = other.deep_copy();
+        m_data = copy;
 
         return *this;
     }
 
-    basic_json& operator=(basic_json&& other) noexcept {
-        m_value.destroy(m_type);
+    // steals the value if both allocators are equal, copies it otherwise
+    basic_json& operator=(basic_json&& other) noexcept(
+        allocator_traits::is_always_equal::value) {
+        if (this == &other)
+            return *this;
+        if (!allocator_traits::is_always_equal::value &&
+            get_allocator() != other.get_allocator())
+            return *this = static_cast<const basic_json&>(other);
 
-        m_type = other.m_type;
-        m_value = other.m_value;
+        destroy();
 
-        other.m_type = value_t::null;
-        other.m_value = value_t(value_t::null);
+        m_data = other.m_data;
+        other.m_data = storage_t();
         return *this;
     }
 
@@ -334,13 +674,18 @@ public:
      * @date 2022_04_18
      */
     static int8_t compare(const basic_json& left, const basic_json& right) {
-        if (left.m_type != right.m_type) {
-            return left.m_type < right.m_type ? -1 : 1;
+        // numbers of different kinds compare by value
+        if (left.is_number() && right.is_number()) {
+            return int8_t(number_value_t::compare(left.number_value(),
+                                                  right.number_value()));
+        }
+        if (left.type() != right.type()) {
+            return left.type() < right.type() ? -1 : 1;
         }
 
-        const auto& left_v = left.m_value;
-        const auto& right_v = right.m_value;
-        switch (left.m_type) {
+        const auto left_v = left.m_data.value();
+        const auto right_v = right.m_data.value();
+        switch (left.type()) {
         default:
         case value_t::null:
             return 0;
@@ -350,14 +695,10 @@ public:
                        ? 0
                        : (left_v.boolean ? 1 : -1);
 
-        case value_t::number:
-            return left_v.number == right_v.number
-                       ? 0
-                       : (left_v.number > right_v.number ? 1 : -1);
-
-        case value_t::string:
-            return int8_t(
-                strcmp(left_v.string->c_str(), right_v.string->c_str()));
+        case value_t::string: {
+            int diff = left.string_view().compare(right.string_view());
+            return diff == 0 ? 0 : (diff > 0 ? 1 : -1);
+        }
 
         case value_t::array: {
             int diff = left_v.array->size() - right_v.array->size();
@@ -388,13 +729,33 @@ public:
             if (diff != 0) {
                 return diff > 0 ? 1 : -1;
             }
-            // compare
-            for (auto it_a = left_v.object->begin(),
-                      it_b = right_v.object->begin();
-                 it_a != left_v.object->end(); it_a++, it_b++) {
-                auto diff = compare(it_a->second, it_b->second);
-                if (diff != 0) {
-                    return diff;
+            // sorted containers (std::map): compare in order
+            if constexpr (is_sorted_object<object_t>::value) {
+                for (auto it_a = left_v.object->begin(),
+                          it_b = right_v.object->begin();
+                     it_a != left_v.object->end(); it_a++, it_b++) {
+                    auto diff = compare(it_a->second, it_b->second);
+                    if (diff != 0) {
+                        return diff;
+                    }
+                }
+            }
+            // otherwise the member order does not matter: compare both in
+            // key order, so that compare(b, a) == -compare(a, b)
+            else {
+                auto a = sorted_members(*left_v.object);
+                auto b = sorted_members(*right_v.object);
+                for (std::size_t i = 0; i < a.size(); i++) {
+                    int diff = a[i].first.compare(b[i].first);
+                    if (diff != 0) {
+                        return diff > 0 ? 1 : -1;
+                    }
+                }
+                for (std::size_t i = 0; i < a.size(); i++) {
+                    auto diff = compare(*a[i].second, *b[i].second);
+                    if (diff != 0) {
+                        return diff;
+                    }
                 }
             }
             return 0;
@@ -403,112 +764,173 @@ public:
     }
 
 private:
-    // 用于深拷贝一个 basic_json 值
-    json_value deep_copy() const {
-        // string
-        if (m_type == value_t::string) {
-            return json_value(*m_value.string);
-        }
-        // array
-        else if (m_type == value_t::array) {
-            auto j = json_value(value_t::array);
-            for (const auto& i : *this->m_value.array) {
-                j.array->push_back(std::move(basic_json(i)));
-            }
-            return j;
-        }
-        // object
-        else if (m_type == value_t::object) {
-            auto j = json_value(value_t::object);
-            for (const auto& i : *this->m_value.object) {
-                j.object->insert(
-                    std::make_pair(i.first, std::move(basic_json(i.second))));
-            }
-            return j;
-        }
-        // else
-        else {
-            return m_value;
-        }
+    // the members of an unsorted object, sorted by key
+    static std::vector<std::pair<std::string_view, const basic_json*>>
+    sorted_members(const object_t& object) {
+        std::vector<std::pair<std::string_view, const basic_json*>> ret;
+        ret.reserve(object.size());
+        for (const auto& i : object)
+            ret.emplace_back(std::string_view(i.first), &i.second);
+        std::sort(ret.begin(), ret.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        return ret;
     }
 
-    // number_t to string_t
-    inline static string_t number_to_dump(number_t number) {
-        char buffer[32];
-        sprintf(buffer, "%.17g", number);
-        return buffer;
+    using number_value_t =
+        ::microlife::detail::number_value<number_t, number_integer_t,
+                                          number_unsigned_t>;
+
+    // the value of a number of any kind
+    number_value_t number_value() const {
+        const auto v = m_data.value();
+        switch (type()) {
+        case value_t::number_integer:
+            return number_value_t::from_integer(v.integer);
+        case value_t::number_unsigned:
+            return number_value_t::from_unsigned(v.unsigned_integer);
+        default:
+            return number_value_t::from_float(v.number);
+        }
     }
 
-    // string_t to dump
-    inline static string_t string_to_dump(const string_t& string) {
-        static const char hex_digits[] = {'0', '1', '2', '3', '4', '5',
-                                          '6', '7', '8', '9', 'A', 'B',
-                                          'C', 'D', 'E', 'F'};
-        string_t ret;
-
-        ret.push_back('\"');
-        auto it = string.begin();
-        while (it != string.end()) {
-            unsigned char ch = (unsigned char)*it;
-
-            switch (ch) {
-            case '\"':
-                ret.push_back('\\');
-                ret.push_back('\"');
-                break;
-
-            case '\\':
-                ret.push_back('\\');
-                ret.push_back('\\');
-                break;
-
-            case '\b':
-                ret.push_back('\\');
-                ret.push_back('b');
-                break;
+    // the element of numbers() at p as a double
+    static double number_at(const unsigned char* p) {
+        return reinterpret_cast<const basic_json*>(p)
+            ->number_value()
+            .template to<double>();
+    }
 
-            case '\f':
-                ret.push_back('\\');
-                ret.push_back('f');
-                break;
+    // storage of an integer: number_integer if it fits, number_unsigned
+    // otherwise, so that equal integers always have the same type
+    template <typename IntegerType>
+    static storage_t make_integer(IntegerType v, const allocator_type& alloc) {
+        if constexpr (std::is_signed_v<IntegerType>) {
+            return integer_storage(value_t::number_integer,
+                                   json_value(number_integer_t(v)), alloc);
+        } else {
+            if (v <= std::make_unsigned_t<number_integer_t>(
+                         std::numeric_limits<number_integer_t>::max()))
+                return integer_storage(value_t::number_integer,
+                                       json_value(number_integer_t(v)),
+                                       alloc);
+            return integer_storage(value_t::number_unsigned,
+                                   json_value(number_unsigned_t(v)), alloc);
+        }
+    }
 
-            case '\n':
-                ret.push_back('\\');
-                ret.push_back('n');
-                break;
+    // storage of the integer v of type t, boxed with alloc if the storage
+    // cannot hold it (see boxed_integers in json_storage.hpp)
+    static storage_t integer_storage(value_t t, json_value v,
+                                     const allocator_type& alloc) {
+        if constexpr (storage_t::boxed_integers) {
+            if (!storage_t::fits_integer(t, v)) {
+                storage_t ret;
+                ret.set_boxed_integer(
+                    t, create<std::uint64_t>(
+                           alloc, t == value_t::number_integer
+                                      ? std::uint64_t(v.integer)
+                                      : std::uint64_t(v.unsigned_integer)));
+                return ret;
+            }
+        }
+        return storage_t(t, v);
+    }
 
-            case '\r':
-                ret.push_back('\\');
-                ret.push_back('r');
-                break;
+    // 释放 string / array / object
+    void destroy() {
+        if constexpr (storage_t::inline_capacity > 0) {
+            if (m_data.is_inline_string())
+                return;
+        }
+        if constexpr (storage_t::boxed_integers) {
+            if (auto* p = m_data.boxed_integer()) {
+                dispose(get_allocator(), p);
+                return;
+            }
+        }
+        m_data.value().destroy(type(), get_allocator());
+    }
 
-            case '\t':
-                ret.push_back('\\');
-                ret.push_back('t');
-                break;
+    // the characters of a string value
+    std::string_view string_view() const {
+        if constexpr (storage_t::inline_capacity > 0) {
+            if (m_data.is_inline_string())
+                return m_data.inline_string();
+        }
+        const auto* str = m_data.value().string;
+        if constexpr (small_strings)
+            return str->view();
+        else
+            return std::string_view(str->data(), str->size());
+    }
 
-            default:
-                if (ch < 0x20) {
-                    ret.push_back('\\');
-                    ret.push_back('u');
-                    ret.push_back('0');
-                    ret.push_back('0');
-                    ret.push_back(hex_digits[ch >> 4]);
-                    ret.push_back(hex_digits[ch & 15]);
-                } else
-                    ret.push_back(*it);
+    // storage of a new string value, short strings are kept inline if the
+    // storage allows it
+    template <typename StringType>
+    static storage_t make_string(StringType&& str,
+                                 const allocator_type& alloc) {
+        if constexpr (storage_t::inline_capacity > 0) {
+            std::string_view view(str);
+            if (view.size() <= storage_t::inline_capacity) {
+                storage_t ret;
+                ret.set_inline_string(view);
+                return ret;
             }
+        }
+        json_value v;
+        v.string = create_string(alloc, std::forward<StringType>(str));
+        return storage_t(value_t::string, v);
+    }
 
-            it++;
+    // 用于深拷贝一个 basic_json 值, 使用 alloc 分配
+    storage_t deep_copy(const allocator_type& alloc) const {
+        // string
+        if (type() == value_t::string) {
+            if constexpr (small_strings)
+                return make_string(string_view(), alloc);
+            else
+                return make_string(*m_data.value().string, alloc);
+        }
+        // array, the elements get the allocator of the new array
+        else if (type() == value_t::array) {
+            auto j = json_value(value_t::array, alloc);
+            j.array->reserve(m_data.value().array->size());
+            for (const auto& i : *m_data.value().array) {
+                j.array->emplace_back(i);
+            }
+            return storage_t(value_t::array, j);
+        }
+        // object
+        else if (type() == value_t::object) {
+            auto j = json_value(value_t::object, alloc);
+            for (const auto& i : *m_data.value().object) {
+                j.object->emplace(i.first, i.second);
+            }
+            return storage_t(value_t::object, j);
+        }
+        // else
+        else {
+            if constexpr (storage_t::boxed_integers) {
+                if (m_data.boxed_integer() != nullptr)
+                    return integer_storage(type(), m_data.value(), alloc);
+            }
+            return m_data;
         }
-        ret.push_back('\"');
-        return ret;
     }
 };
 
+// 默认 policy 下一个节点 = 1 字节类型 + 8 字节 union, 对齐后 16 字节
+static_assert(sizeof(basic_json<>) <= 16,
+              "basic_json<> must stay a 16 byte node");
+static_assert(!std::is_polymorphic_v<basic_json<>>,
+              "basic_json<> must not have a vtable");
+
 // cout baisc_json
-inline std::ostream& operator<<(std::ostream& os, const basic_json& type) {
-    return os << type.dump();
+template <typename Policy>
+inline std::ostream& operator<<(std::ostream& os,
+                                const basic_json<Policy>& type) {
+    type.dump(os);
+    return os;
 }
 } // namespace detail
 } // namespace microlife
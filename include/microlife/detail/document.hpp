@@ -0,0 +1,884 @@
+#pragma once
+#include "arena.hpp"
+#include "basic_json.hpp"
+#include "lexer.hpp"
+#include "macro_scope.hpp" // json_assert()
+#include "number_value.hpp"
+#include "output_adapter.hpp"
+#include "serializer.hpp"
+#include "structural_parser.hpp"
+#include "value_t.hpp"
+
+#include <algorithm>   // copy
+#include <atomic>      // atomic
+#include <cstdint>     // int64_t, uint32_t, uint64_t, UINT32_MAX
+#include <cstring>     // memcpy
+#include <limits>      // numeric_limits
+#include <memory>      // shared_ptr, make_shared
+#include <new>         // placement new
+#include <thread>      // this_thread::yield
+#include <ostream>     // ostream
+#include <string>      // string
+#include <string_view> // string_view
+#include <type_traits> // enable_if, is_convertible, is_same
+#include <utility>     // forward, move
+#include <vector>      // vector
+
+namespace microlife {
+namespace detail {
+// options of basic_document::parse(), borrow() and parse_in_situ()
+struct document_options {
+    // numbers keep their text and are converted on the first read
+    bool lazy_numbers = false;
+    // parse with structural_parser (SIMD index of the tokens first), for
+    // inputs convertible to std::string_view; others use parser
+    bool structural = false;
+};
+
+/***
+ * @brief read-only JSON document backed by an arena
+ * @details parse() builds the whole tree in one arena (see arena.hpp):
+ * nodes, strings and the element storage of arrays and objects. Nothing
+ * is freed one by one, clear() and the next parse() drop the whole tree
+ * in O(1) and reuse the memory, so parsing documents of a similar size in
+ * a loop does not touch the heap once warmed up.
+ * Arrays and objects are stored as contiguous runs of nodes in source
+ * order. Object lookup is linear, a duplicated key finds the last value.
+ * The nodes are only valid until the next parse() or clear(), a document
+ * can be neither copied nor moved.
+ * With parse_options::lazy_numbers a number keeps its text instead of its
+ * value: it is converted on the first read (and the result kept), dump()
+ * writes the text back byte for byte. Documents that are mostly forwarded
+ * skip the conversions, and decimals of any precision pass through
+ * unchanged. Such a number is only checked against the grammar, one out
+ * of the range of double is accepted and reads as +-infinity.
+ * borrow() parses without copying the strings: a string without escapes
+ * is a view into the input, a string with escapes is decoded on its first
+ * read into space reserved in the arena (the decoded form is never
+ * longer), keys with escapes are decoded while parsing. A std::string
+ * passed by rvalue or a shared_ptr<const std::string> is kept alive by
+ * the document until the next parse(), borrow(), clear() or release().
+ * borrow(std::string_view) is the unchecked form: the caller keeps the
+ * input alive and unchanged as long as the nodes are used, nothing
+ * enforces it. A borrowed string is not null terminated
+ * (get<const char*>() asserts).
+ * parse_in_situ() takes a mutable buffer owned by the caller and needs no
+ * memory for the strings at all: escapes are decoded in place and the
+ * closing quote of every string is replaced by a null byte, the strings
+ * are null terminated runs of the buffer. The buffer is no longer valid
+ * JSON afterwards and has the lifetime rules of borrow().
+ * @author qingl
+ * @date 2026_10_17
+ */
+class basic_document {
+public:
+    using value_t = detail::value_t;
+
+    class node;
+    struct member;
+    using parse_options = document_options;
+
+    // [begin, end) of nodes or members
+    template <typename T>
+    class range {
+    private:
+        T* m_first;
+        T* m_last;
+
+    public:
+        range(T* first, T* last) : m_first(first), m_last(last) {}
+        T* begin() const { return m_first; }
+        T* end() const { return m_last; }
+        std::size_t size() const { return std::size_t(m_last - m_first); }
+    };
+
+private:
+    // where the strings of the nodes live
+    enum class string_mode {
+        copy,   // parse(): in the arena
+        borrow, // borrow(): views into the input, decoded on first read
+        in_situ // parse_in_situ(): decoded in the input buffer
+    };
+
+    /***
+     * @brief a number kept as text (lazy_numbers)
+     * @details The text follows the object in the arena. The value is
+     * converted by the first read, concurrent first reads of a const
+     * document both convert and store the same result.
+     */
+    struct lazy_number {
+        mutable std::atomic<std::uint64_t> m_bits{0};
+        mutable std::atomic<value_t> m_type{value_t::null}; // not converted
+
+        const char* text() const {
+            return reinterpret_cast<const char*>(this + 1);
+        }
+
+        number_value<double> value(std::uint32_t size) const {
+            number_value<double> ret;
+            auto type = m_type.load(std::memory_order_acquire);
+            if (type == value_t::null) {
+                ret = convert(size);
+                std::uint64_t bits;
+                std::memcpy(&bits, &ret.number, sizeof(bits));
+                m_bits.store(bits, std::memory_order_relaxed);
+                m_type.store(ret.type, std::memory_order_release);
+                return ret;
+            }
+            auto bits = m_bits.load(std::memory_order_relaxed);
+            ret.type = type;
+            std::memcpy(&ret.number, &bits, sizeof(bits));
+            return ret;
+        }
+
+    private:
+        // the text was validated by the parser, a number out of the range
+        // of double (rejected by an eager parse) reads as +-infinity
+        number_value<double> convert(std::uint32_t size) const {
+            lexer<basic_json<>> lex;
+            lex.init(text(), text() + size);
+            if (lex.scan() != token_t::value_number) {
+                const double inf = std::numeric_limits<double>::infinity();
+                return number_value<double>::from_float(text()[0] == '-'
+                                                            ? -inf
+                                                            : inf);
+            }
+            switch (lex.get_number_type()) {
+            case value_t::number_integer:
+                return number_value<double>::from_integer(
+                    lex.get_number_integer());
+            case value_t::number_unsigned:
+                return number_value<double>::from_unsigned(
+                    lex.get_number_unsigned());
+            default:
+                return number_value<double>::from_float(lex.get_number());
+            }
+        }
+    };
+
+    /***
+     * @brief a string with escapes of a borrowed input
+     * @details Followed in the arena by room for the decoded string (the
+     * raw length + 1). Decoded by the first read, a concurrent first read
+     * waits for it.
+     */
+    struct lazy_string {
+        enum : std::uint8_t { raw, decoding, decoded };
+
+        const char* m_raw;              // the text in the input
+        mutable std::uint32_t m_size = 0; // the decoded length
+        mutable std::atomic<std::uint8_t> m_state{raw};
+
+        explicit lazy_string(const char* raw_text) : m_raw(raw_text) {}
+
+        std::string_view value(std::uint32_t raw_size) const {
+            if (m_state.load(std::memory_order_acquire) != decoded)
+                decode(raw_size);
+            return std::string_view(buffer(), m_size);
+        }
+
+    private:
+        char* buffer() const {
+            return reinterpret_cast<char*>(const_cast<lazy_string*>(this) +
+                                           1);
+        }
+
+        void decode(std::uint32_t raw_size) const {
+            std::uint8_t expected = raw;
+            if (!m_state.compare_exchange_strong(expected, decoding,
+                                                 std::memory_order_acquire)) {
+                while (m_state.load(std::memory_order_acquire) != decoded)
+                    std::this_thread::yield();
+                return;
+            }
+            char* last = lexer<basic_json<>>::unescape(
+                m_raw, m_raw + raw_size, buffer());
+            *last = '\0';
+            m_size = std::uint32_t(last - buffer());
+            m_state.store(decoded, std::memory_order_release);
+        }
+    };
+
+public:
+    /***
+     * @brief a value of the document
+     * @details 16 bytes: the type, a length and a pointer or a scalar.
+     * The read functions follow basic_json.
+     */
+    class node {
+    private:
+        friend class basic_document;
+
+        // m_flags
+        enum : std::uint8_t {
+            lazy = 1, // the value is a lazy_number / lazy_string
+            view = 2  // a string in a borrowed input, not null terminated
+        };
+
+        value_t m_type = value_t::null;
+        std::uint8_t m_flags = 0;
+        std::uint32_t m_size = 0; // string length / number of elements
+
+        union {
+            bool boolean;
+            double number;
+            std::int64_t integer;
+            std::uint64_t unsigned_integer;
+            const char* string; // null terminated
+            const node* array;
+            const member* object;
+            const lazy_number* raw_number;
+            const lazy_string* raw_string;
+        } m_value = {};
+
+    public:
+        // a lazy number is converted to tell its kind
+        value_t type() const {
+            return (m_flags & lazy) && m_type == value_t::number
+                       ? m_value.raw_number->value(m_size).type
+                       : m_type;
+        }
+
+        bool is_null() const { return m_type == value_t::null; }
+        bool is_boolean() const { return m_type == value_t::boolean; }
+        // a number of any kind, see basic_json
+        bool is_number() const {
+            return m_type == value_t::number ||
+                   m_type == value_t::number_integer ||
+                   m_type == value_t::number_unsigned;
+        }
+        bool is_string() const { return m_type == value_t::string; }
+        bool is_array() const { return m_type == value_t::array; }
+        bool is_object() const { return m_type == value_t::object; }
+
+        // T get<T>()
+        // bool, integer types (range checked), double, std::string,
+        // std::string_view, const char*
+        template <typename T>
+        T get() const {
+            if constexpr (std::is_same_v<T, bool>) {
+                json_assert(is_boolean());
+                return m_value.boolean;
+            } else if constexpr (std::is_integral_v<T>) {
+                json_assert(is_number());
+                const auto n = number();
+                json_assert(n.template fits<T>());
+                return n.template to<T>();
+            } else if constexpr (std::is_floating_point_v<T>) {
+                json_assert(is_number());
+                return number().template to<T>();
+            } else if constexpr (std::is_same_v<T, std::string>) {
+                json_assert(is_string());
+                return std::string(text());
+            } else if constexpr (std::is_same_v<T, std::string_view>) {
+                json_assert(is_string());
+                return text();
+            } else if constexpr (std::is_same_v<T, const char*>) {
+                json_assert(is_string() && !(m_flags & view));
+                return text().data();
+            } else {
+                static_assert(std::is_same_v<T, bool>,
+                              "basic_document::node::get<T>() : T is not "
+                              "supported");
+            }
+        }
+
+        // number of elements of an array or object, length of a string
+        std::size_t size() const {
+            if (m_flags & lazy)
+                return is_string() ? text().size() : 0;
+            return m_size;
+        }
+        bool empty() const { return size() == 0; }
+
+        // the elements of an array
+        range<const node> elements() const {
+            json_assert(is_array());
+            return {m_value.array, m_value.array + m_size};
+        }
+
+        // the members of an object, in source order
+        range<const member> items() const {
+            json_assert(is_object());
+            return {m_value.object, m_value.object + m_size};
+        }
+
+        // array element
+        const node& operator[](std::size_t index) const {
+            json_assert(is_array() && index < m_size);
+            return m_value.array[index];
+        }
+
+        // object member, the key must exist
+        const node& operator[](std::string_view key) const {
+            auto p = find(key);
+            json_assert(p != nullptr);
+            return *p;
+        }
+
+        // object member, nullptr if not found (or not an object)
+        const node* find(std::string_view key) const {
+            if (!is_object())
+                return nullptr;
+            // the last one wins, like basic_json
+            for (auto i = m_size; i > 0; i--) {
+                const member& m = m_value.object[i - 1];
+                if (m.key_size == key.size() &&
+                    std::char_traits<char>::compare(m.key, key.data(),
+                                                    key.size()) == 0)
+                    return &m.value;
+            }
+            return nullptr;
+        }
+
+        bool contains(std::string_view key) const {
+            return find(key) != nullptr;
+        }
+
+        // get a string representation of the value (serialize)
+        std::string dump() const {
+            std::string ret;
+            auto out = ::microlife::detail::output_adapter(ret);
+            dump_to(out);
+            return ret;
+        }
+
+        // write the serialization to any output adapter
+        template <typename OutputAdapterType>
+        void dump_to(OutputAdapterType& output) const;
+
+        friend bool operator==(const node& left, const node& right) {
+            if (left.is_number() && right.is_number())
+                return number_value<double>::compare(left.number(),
+                                                     right.number()) == 0;
+            if (left.m_type != right.m_type)
+                return false;
+            switch (left.m_type) {
+            default:
+            case value_t::null:
+                return true;
+            case value_t::boolean:
+                return left.m_value.boolean == right.m_value.boolean;
+            case value_t::string:
+                return left.get<std::string_view>() ==
+                       right.get<std::string_view>();
+            case value_t::array:
+                if (left.m_size != right.m_size)
+                    return false;
+                for (std::uint32_t i = 0; i < left.m_size; i++) {
+                    if (!(left.m_value.array[i] == right.m_value.array[i]))
+                        return false;
+                }
+                return true;
+            case value_t::object:
+                if (left.m_size != right.m_size)
+                    return false;
+                for (const auto& m : left.items()) {
+                    auto other = right.find(m.key_view());
+                    if (other == nullptr || !(m.value == *other))
+                        return false;
+                }
+                return true;
+            }
+        }
+
+        friend bool operator!=(const node& left, const node& right) {
+            return !(left == right);
+        }
+
+    private:
+        // the characters of a string
+        std::string_view text() const {
+            if (m_flags & lazy)
+                return m_value.raw_string->value(m_size);
+            return std::string_view(m_value.string, m_size);
+        }
+
+        // the value of a number of any kind
+        number_value<double> number() const {
+            if (m_flags & lazy)
+                return m_value.raw_number->value(m_size);
+            switch (m_type) {
+            case value_t::number_integer:
+                return number_value<double>::from_integer(m_value.integer);
+            case value_t::number_unsigned:
+                return number_value<double>::from_unsigned(
+                    m_value.unsigned_integer);
+            default:
+                return number_value<double>::from_float(m_value.number);
+            }
+        }
+    };
+
+    // an object member
+    struct member {
+        const char* key; // null terminated, unless borrowed
+        std::uint32_t key_size;
+        node value;
+
+        std::string_view key_view() const {
+            return std::string_view(key, key_size);
+        }
+    };
+
+private:
+    /***
+     * @brief SAX handler building the nodes
+     * @details Finished values wait on a scratch stack until their array or
+     * object is closed, then they are copied to the arena in one block. The
+     * scratch stacks keep their capacity between two documents.
+     */
+    class builder {
+    public:
+        using string_t = basic_json<>::string_t;
+        using number_t = basic_json<>::number_t;
+        using number_integer_t = basic_json<>::number_integer_t;
+        using number_unsigned_t = basic_json<>::number_unsigned_t;
+        using boolean_t = basic_json<>::boolean_t;
+
+    private:
+        // an array or object that is still open
+        struct frame {
+            std::size_t start; // its first value on m_values
+            const char* key;   // its key in the parent object
+            std::uint32_t key_size;
+        };
+
+        arena* m_arena = nullptr;
+        std::vector<member> m_values; // finished values, innermost last
+        std::vector<frame> m_frames;  // open arrays/objects
+        const char* m_key = nullptr;  // key of the next value
+        std::uint32_t m_key_size = 0;
+        bool m_lazy_numbers = false;
+        string_mode m_strings = string_mode::copy;
+
+    public:
+        void reset(arena& a, const parse_options& options,
+                   string_mode strings) {
+            m_arena = &a;
+            m_lazy_numbers = options.lazy_numbers;
+            m_strings = strings;
+            m_values.clear();
+            m_frames.clear();
+            m_key = nullptr;
+            m_key_size = 0;
+        }
+
+        // the root, once the document is complete
+        node root() const {
+            json_assert(m_values.size() == 1 && m_frames.empty());
+            return m_values.back().value;
+        }
+
+        bool null() { return push({}); }
+
+        bool boolean(boolean_t val) {
+            node n;
+            n.m_type = value_t::boolean;
+            n.m_value.boolean = val;
+            return push(n);
+        }
+
+        bool number(number_t val) {
+            node n;
+            n.m_type = value_t::number;
+            n.m_value.number = val;
+            return push(n);
+        }
+
+        bool number_integer(number_integer_t val) {
+            node n;
+            n.m_type = value_t::number_integer;
+            n.m_value.integer = val;
+            return push(n);
+        }
+
+        bool number_unsigned(number_unsigned_t val) {
+            node n;
+            n.m_type = value_t::number_unsigned;
+            n.m_value.unsigned_integer = val;
+            return push(n);
+        }
+
+        // lazy_numbers: the parser reports the text of the numbers
+        bool raw_numbers() const { return m_lazy_numbers; }
+
+        bool number_text(std::string_view text) {
+            if (!fits(text.size()))
+                return false;
+            auto p = m_arena->allocate_bytes(sizeof(lazy_number) + text.size(),
+                                             alignof(lazy_number));
+            auto lazy = new (p) lazy_number;
+            std::memcpy(const_cast<char*>(lazy->text()), text.data(),
+                        text.size());
+            node n;
+            n.m_type = value_t::number;
+            n.m_flags = node::lazy;
+            n.m_size = std::uint32_t(text.size());
+            n.m_value.raw_number = lazy;
+            return push(n);
+        }
+
+        // borrow() / parse_in_situ(): the parser reports the text of the
+        // strings
+        bool raw_strings() const { return m_strings != string_mode::copy; }
+
+        bool string_text(std::string_view text, bool escaped) {
+            if (!fits(text.size()))
+                return false;
+            node n;
+            n.m_type = value_t::string;
+            n.m_size = std::uint32_t(text.size());
+            if (m_strings == string_mode::in_situ) {
+                n.m_value.string = decode_in_situ(text, escaped, n.m_size);
+            } else if (escaped) {
+                // decoded on the first read
+                auto p = m_arena->allocate_bytes(
+                    sizeof(lazy_string) + text.size() + 1,
+                    alignof(lazy_string));
+                n.m_flags = node::lazy;
+                n.m_value.raw_string = new (p) lazy_string(text.data());
+            } else {
+                n.m_flags = node::view;
+                n.m_value.string = text.data();
+            }
+            return push(n);
+        }
+
+        bool key_text(std::string_view text, bool escaped) {
+            if (!fits(text.size()))
+                return false;
+            if (m_strings == string_mode::in_situ) {
+                m_key_size = std::uint32_t(text.size());
+                m_key = decode_in_situ(text, escaped, m_key_size);
+            } else if (escaped) {
+                // keys are compared by every lookup, decode them now
+                auto p = m_arena->allocate_array<char>(text.size() + 1);
+                auto last = lexer<basic_json<>>::unescape(
+                    text.data(), text.data() + text.size(), p);
+                *last = '\0';
+                m_key = p;
+                m_key_size = std::uint32_t(last - p);
+            } else {
+                m_key = text.data();
+                m_key_size = std::uint32_t(text.size());
+            }
+            return true;
+        }
+
+        bool string(string_t& val) {
+            if (!fits(val.size()))
+                return false;
+            node n;
+            n.m_type = value_t::string;
+            n.m_size = std::uint32_t(val.size());
+            n.m_value.string = m_arena->copy_string(val.data(), val.size());
+            return push(n);
+        }
+
+        bool key(string_t& val) {
+            if (!fits(val.size()))
+                return false;
+            m_key = m_arena->copy_string(val.data(), val.size());
+            m_key_size = std::uint32_t(val.size());
+            return true;
+        }
+
+        bool start_object() { return open(); }
+        bool start_array() { return open(); }
+
+        bool end_object() {
+            std::size_t start = m_frames.back().start;
+            std::size_t count = m_values.size() - start;
+            if (!fits(count))
+                return false;
+
+            node n;
+            n.m_type = value_t::object;
+            n.m_size = std::uint32_t(count);
+            auto members = m_arena->allocate_array<member>(count);
+            std::copy(m_values.begin() + start, m_values.end(), members);
+            n.m_value.object = members;
+            return close(n);
+        }
+
+        bool end_array() {
+            std::size_t start = m_frames.back().start;
+            std::size_t count = m_values.size() - start;
+            if (!fits(count))
+                return false;
+
+            node n;
+            n.m_type = value_t::array;
+            n.m_size = std::uint32_t(count);
+            auto elements = m_arena->allocate_array<node>(count);
+            for (std::size_t i = 0; i < count; i++)
+                elements[i] = m_values[start + i].value;
+            n.m_value.array = elements;
+            return close(n);
+        }
+
+    private:
+        // lengths are stored in 32 bits
+        static bool fits(std::size_t n) { return n <= UINT32_MAX; }
+
+        // parse_in_situ(): decode text where it is, in the caller's mutable
+        // buffer, the closing quote (already consumed by the lexer) becomes
+        // the null byte. size: the length of text, then the decoded one
+        static const char* decode_in_situ(std::string_view text, bool escaped,
+                                          std::uint32_t& size) {
+            auto first = const_cast<char*>(text.data());
+            char* last = first + text.size();
+            if (escaped) {
+                last = lexer<basic_json<>>::unescape(first, last, first);
+                size = std::uint32_t(last - first);
+            }
+            *last = '\0';
+            return first;
+        }
+
+        bool push(const node& n) {
+            m_values.push_back({m_key, m_key_size, n});
+            m_key = nullptr;
+            m_key_size = 0;
+            return true;
+        }
+
+        bool open() {
+            m_frames.push_back({m_values.size(), m_key, m_key_size});
+            m_key = nullptr;
+            m_key_size = 0;
+            return true;
+        }
+
+        bool close(const node& n) {
+            const frame f = m_frames.back();
+            m_frames.pop_back();
+            m_values.resize(f.start);
+            m_values.push_back({f.key, f.key_size, n});
+            return true;
+        }
+    };
+
+    arena m_arena;
+    builder m_builder;
+    structural_parser<basic_json<>> m_structural; // parse_options::structural
+    node m_root;
+    std::shared_ptr<const std::string> m_input; // kept alive by borrow()
+
+public:
+    basic_document() = default;
+    basic_document(const basic_document&) = delete;
+    basic_document& operator=(const basic_document&) = delete;
+
+    // parse the input into this document, the previous tree is dropped
+    // input: anything accepted by basic_json::parse()
+    // on failure the document is empty (root is null)
+    template <typename InputType>
+    bool parse(InputType&& input, const parse_options& options = {}) {
+        return parse_internal(std::forward<InputType>(input), options,
+                              string_mode::copy);
+    }
+
+    // parse [first, last)
+    template <typename IteratorType>
+    bool parse(IteratorType first, IteratorType last,
+               const parse_options& options = {}) {
+        return parse(::microlife::detail::input_adapter(first, last),
+                     options);
+    }
+
+    // parse the input without copying its strings: they are views into
+    // input, which the document keeps alive (see the class comment)
+    bool borrow(std::shared_ptr<const std::string> input,
+                const parse_options& options = {}) {
+        json_assert(input != nullptr);
+        if (!parse_internal(std::string_view(*input), options,
+                            string_mode::borrow))
+            return false;
+        m_input = std::move(input);
+        return true;
+    }
+
+    // the same, the string is moved into the document
+    template <typename T, typename = std::enable_if_t<
+                              std::is_same_v<T, std::string>>>
+    bool borrow(T&& input, const parse_options& options = {}) {
+        return borrow(std::make_shared<const std::string>(std::move(input)),
+                      options);
+    }
+
+    // unchecked: input must stay alive and unchanged as long as the nodes
+    // are used, the document does not keep it
+    bool borrow(std::string_view input, const parse_options& options = {}) {
+        return parse_internal(input, options, string_mode::borrow);
+    }
+
+    // parse [buffer, buffer + size) in place: the strings are decoded into
+    // the buffer and the nodes point into it, the buffer must stay alive
+    // as long as the nodes are used (see the class comment), its content
+    // is unspecified after a failed parse
+    bool parse_in_situ(char* buffer, std::size_t size,
+                       const parse_options& options = {}) {
+        return parse_internal(std::string_view(buffer, size), options,
+                              string_mode::in_situ);
+    }
+
+    // drop the tree, keep the memory for the next parse()
+    void clear() {
+        m_root = node();
+        m_arena.reset();
+        m_input.reset();
+    }
+
+    // drop the tree and return the memory to the heap
+    void release() {
+        m_root = node();
+        m_arena.release();
+        m_input.reset();
+        m_structural.release();
+    }
+
+    const node& root() const { return m_root; }
+
+    // bytes of the arena used by the current tree
+    std::size_t memory_usage() const { return m_arena.used(); }
+
+    std::string dump() const { return m_root.dump(); }
+
+private:
+    template <typename InputType>
+    bool parse_internal(InputType&& input, const parse_options& options,
+                        string_mode strings) {
+        clear();
+        m_builder.reset(m_arena, options, strings);
+        bool ok;
+        if constexpr (std::is_convertible_v<InputType&&, std::string_view>) {
+            if (options.structural) {
+                ok = m_structural.sax_parse(
+                    std::string_view(std::forward<InputType>(input)),
+                    &m_builder);
+            } else {
+                ok = basic_json<>::sax_parse(std::forward<InputType>(input),
+                                             &m_builder);
+            }
+        } else {
+            ok = basic_json<>::sax_parse(std::forward<InputType>(input),
+                                         &m_builder);
+        }
+        if (!ok) {
+            clear();
+            return false;
+        }
+        m_root = m_builder.root();
+        return true;
+    }
+};
+
+/***
+ * @brief writes a basic_document::node to an output adapter
+ * @details Walks nested arrays and objects with an explicit stack, like
+ * serializer does for basic_json.
+ */
+template <typename OutputAdapterType>
+void basic_document::node::dump_to(OutputAdapterType& output) const {
+    // an array or object being written
+    struct frame {
+        const node* value;
+        std::uint32_t index;
+    };
+
+    output_writer<OutputAdapterType> out(output);
+    std::vector<frame> stack;
+
+    const node* cur = this;
+    while (true) {
+        // write cur, open a non-empty container
+        switch (cur->m_type) {
+        default:
+        case value_t::null:
+            out.write_null();
+            break;
+        case value_t::boolean:
+            out.write_boolean(cur->m_value.boolean);
+            break;
+        case value_t::number:
+            if (cur->m_flags & lazy)
+                out.write_characters(cur->m_value.raw_number->text(),
+                                     cur->m_size);
+            else
+                out.write_number(cur->m_value.number);
+            break;
+        case value_t::number_integer:
+            out.write_integer(cur->m_value.integer);
+            break;
+        case value_t::number_unsigned:
+            out.write_unsigned(cur->m_value.unsigned_integer);
+            break;
+        case value_t::string:
+            if (cur->m_flags & lazy) {
+                // the escapes of the input are valid JSON, write them back
+                out.write_character('"');
+                out.write_characters(cur->m_value.raw_string->m_raw,
+                                     cur->m_size);
+                out.write_character('"');
+            } else {
+                out.write_string(cur->m_value.string, cur->m_size);
+            }
+            break;
+        case value_t::array:
+            if (cur->m_size == 0) {
+                out.write_characters("[]", 2);
+                break;
+            }
+            out.write_character('[');
+            stack.push_back({cur, 0});
+            cur = &cur->m_value.array[0];
+            continue;
+        case value_t::object:
+            if (cur->m_size == 0) {
+                out.write_characters("{}", 2);
+                break;
+            }
+            out.write_character('{');
+            stack.push_back({cur, 0});
+            out.write_string(cur->m_value.object[0].key,
+                             cur->m_value.object[0].key_size);
+            out.write_character(':');
+            cur = &cur->m_value.object[0].value;
+            continue;
+        }
+
+        // the next value, close finished containers
+        while (true) {
+            if (stack.empty())
+                return;
+            auto& f = stack.back();
+            if (++f.index < f.value->m_size) {
+                out.write_character(',');
+                if (f.value->m_type == value_t::array) {
+                    cur = &f.value->m_value.array[f.index];
+                } else {
+                    const member& m = f.value->m_value.object[f.index];
+                    out.write_string(m.key, m.key_size);
+                    out.write_character(':');
+                    cur = &m.value;
+                }
+                break;
+            }
+            out.write_character(f.value->m_type == value_t::array ? ']'
+                                                                  : '}');
+            stack.pop_back();
+        }
+    }
+}
+
+// cout basic_document::node
+inline std::ostream& operator<<(std::ostream& os,
+                                const basic_document::node& n) {
+    auto out = ::microlife::detail::output_adapter(os);
+    n.dump_to(out);
+    return os;
+}
+} // namespace detail
+} // namespace microlife
@@ -0,0 +1,370 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+
+#include <cstddef>          // size_t
+#include <cstdint>          // uint32_t
+#include <functional>       // hash
+#include <initializer_list> // initializer_list
+#include <memory>           // allocator, allocator_traits
+#include <string_view>      // string_view
+#include <tuple>            // forward_as_tuple
+#include <type_traits>      // enable_if, is_convertible, is_same
+#include <utility>          // pair, piecewise_construct
+#include <vector>           // vector
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief JSON object container: flat vector, hash index when large
+ * @details The members are stored contiguously in a vector of
+ * std::pair<Key, T>. Up to linear_limit members a key is found by a linear
+ * scan, which for small objects beats any tree or hash (one cache line
+ * per few members, no pointer chasing). Beyond that an open-addressing
+ * index (linear probing, 32 bit hash + position per slot, load <= 1/2)
+ * is built over the vector and kept up to date.
+ * Iteration follows the vector: members appear in insertion order until
+ * one is erased, erase() moves the last member into the hole (O(1)).
+ * With KeepOrder (see ordered_object) erase() shifts the following members
+ * instead (O(n)), so the insertion order always holds. Lookups cost the
+ * same in both modes.
+ * Key must be a string type convertible to std::string_view, keys are
+ * looked up by anything convertible to std::string_view. A probe of type
+ * Key is compared with Key's ==, so interned keys (see key_table.hpp)
+ * compare by address. Do not modify a key through an iterator.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename Key, typename T,
+          typename Allocator = std::allocator<std::pair<Key, T>>,
+          bool KeepOrder = false>
+class hybrid_object {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+    // objects up to this size have no index
+    static constexpr size_type linear_limit = 16;
+
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    // a slot of the index, position + 1 of the member, 0 is empty
+    struct slot {
+        std::uint32_t index;
+        std::uint32_t hash;
+    };
+
+    using entry_vector =
+        std::vector<value_type,
+                    typename alloc_traits::template rebind_alloc<value_type>>;
+    using slot_vector =
+        std::vector<slot, typename alloc_traits::template rebind_alloc<slot>>;
+
+    static constexpr size_type npos = size_type(-1);
+
+    // enables the lookup overloads for key types, not for iterators
+    template <typename K>
+    using if_key =
+        std::enable_if_t<std::is_convertible_v<const K&, std::string_view>,
+                         int>;
+
+    entry_vector m_entries;
+    slot_vector m_index; // empty while size() <= linear_limit
+
+public:
+    using iterator = typename entry_vector::iterator;
+    using const_iterator = typename entry_vector::const_iterator;
+
+    hybrid_object() = default;
+    explicit hybrid_object(const allocator_type& alloc)
+        : m_entries(alloc), m_index(alloc) {}
+    hybrid_object(const hybrid_object& other, const allocator_type& alloc)
+        : m_entries(other.m_entries, alloc), m_index(other.m_index, alloc) {}
+    hybrid_object(hybrid_object&& other, const allocator_type& alloc)
+        : m_entries(std::move(other.m_entries), alloc),
+          m_index(std::move(other.m_index), alloc) {}
+    hybrid_object(std::initializer_list<value_type> init,
+                  const allocator_type& alloc = allocator_type())
+        : hybrid_object(alloc) {
+        for (const auto& i : init)
+            emplace(i.first, i.second);
+    }
+
+    hybrid_object(const hybrid_object&) = default;
+    hybrid_object(hybrid_object&&) = default;
+    hybrid_object& operator=(const hybrid_object&) = default;
+    hybrid_object& operator=(hybrid_object&&) = default;
+
+    allocator_type get_allocator() const { return m_entries.get_allocator(); }
+
+    iterator begin() noexcept { return m_entries.begin(); }
+    iterator end() noexcept { return m_entries.end(); }
+    const_iterator begin() const noexcept { return m_entries.begin(); }
+    const_iterator end() const noexcept { return m_entries.end(); }
+    const_iterator cbegin() const noexcept { return m_entries.cbegin(); }
+    const_iterator cend() const noexcept { return m_entries.cend(); }
+
+    size_type size() const noexcept { return m_entries.size(); }
+    bool empty() const noexcept { return m_entries.empty(); }
+
+    // the members, contiguous, in iteration order
+    const value_type* data() const noexcept { return m_entries.data(); }
+
+    void clear() noexcept {
+        m_entries.clear();
+        m_index.clear();
+    }
+
+    void reserve(size_type n) {
+        m_entries.reserve(n);
+        if (n > linear_limit && index_capacity(n) > m_index.size() &&
+            !m_index.empty())
+            rehash(index_capacity(n));
+    }
+
+    // key: anything convertible to std::string_view; a probe of type Key
+    // is compared with == (interned_key: by address)
+    template <typename K, if_key<K> = 0>
+    iterator find(const K& key) {
+        auto pos = find_position(key);
+        return pos == npos ? end() : begin() + pos;
+    }
+    template <typename K, if_key<K> = 0>
+    const_iterator find(const K& key) const {
+        auto pos = find_position(key);
+        return pos == npos ? end() : begin() + pos;
+    }
+
+    template <typename K, if_key<K> = 0>
+    size_type count(const K& key) const {
+        return find_position(key) == npos ? 0 : 1;
+    }
+    template <typename K, if_key<K> = 0>
+    bool contains(const K& key) const {
+        return find_position(key) != npos;
+    }
+
+    template <typename K, if_key<K> = 0>
+    T& at(const K& key) {
+        auto pos = find_position(key);
+        json_assert(pos != npos);
+        return m_entries[pos].second;
+    }
+    template <typename K, if_key<K> = 0>
+    const T& at(const K& key) const {
+        auto pos = find_position(key);
+        json_assert(pos != npos);
+        return m_entries[pos].second;
+    }
+
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+    T& operator[](Key&& key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    // inserts (key, T(args...)) if key is not present
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        auto pos = find_position(key);
+        if (pos != npos)
+            return {begin() + pos, false};
+
+        m_entries.emplace_back(
+            std::piecewise_construct,
+            std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        index_last();
+        return {end() - 1, true};
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
+        return try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return try_emplace(value.first, value.second);
+    }
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    // the last member takes the place of the erased one (KeepOrder: the
+    // following members move up), returns the iterator to that position
+    iterator erase(const_iterator it) {
+        auto pos = size_type(it - cbegin());
+        erase_at(pos);
+        return begin() + pos;
+    }
+
+    template <typename K, if_key<K> = 0>
+    size_type erase(const K& key) {
+        auto pos = find_position(key);
+        if (pos == npos)
+            return 0;
+        erase_at(pos);
+        return 1;
+    }
+
+    void swap(hybrid_object& other) noexcept {
+        m_entries.swap(other.m_entries);
+        m_index.swap(other.m_index);
+    }
+
+    // same members, in any order
+    friend bool operator==(const hybrid_object& lhs, const hybrid_object& rhs) {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (const auto& i : lhs) {
+            auto it = rhs.find(i.first);
+            if (it == rhs.end() || !(it->second == i.second))
+                return false;
+        }
+        return true;
+    }
+    friend bool operator!=(const hybrid_object& lhs, const hybrid_object& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    static std::uint32_t hash(std::string_view key) noexcept {
+        return std::uint32_t(std::hash<std::string_view>()(key));
+    }
+
+    // a power of two, at least twice n
+    static size_type index_capacity(size_type n) noexcept {
+        size_type ret = 2 * linear_limit;
+        while (ret < 2 * n)
+            ret *= 2;
+        return ret;
+    }
+
+    // a stored key equals the probe key (view: the probe as a string)
+    template <typename K>
+    static bool key_equal(const Key& stored, const K& key,
+                          std::string_view view) {
+        if constexpr (std::is_same_v<K, Key>)
+            return stored == key;
+        else
+            return std::string_view(stored) == view;
+    }
+
+    template <typename K>
+    size_type find_position(const K& key) const {
+        std::string_view view(key);
+        if (m_index.empty()) {
+            for (size_type i = 0; i < m_entries.size(); i++) {
+                if (key_equal(m_entries[i].first, key, view))
+                    return i;
+            }
+            return npos;
+        }
+
+        auto h = hash(view);
+        auto mask = m_index.size() - 1;
+        for (auto i = h & mask;; i = (i + 1) & mask) {
+            const auto& s = m_index[i];
+            if (s.index == 0)
+                return npos;
+            if (s.hash == h &&
+                key_equal(m_entries[s.index - 1].first, key, view))
+                return s.index - 1;
+        }
+    }
+
+    // the slot holding position pos
+    size_type find_slot(size_type pos) const {
+        auto mask = m_index.size() - 1;
+        auto h = hash(m_entries[pos].first);
+        for (auto i = h & mask;; i = (i + 1) & mask) {
+            if (m_index[i].index == pos + 1)
+                return i;
+        }
+    }
+
+    void insert_slot(size_type pos, std::uint32_t h) {
+        auto mask = m_index.size() - 1;
+        auto i = h & mask;
+        while (m_index[i].index != 0)
+            i = (i + 1) & mask;
+        m_index[i] = slot{std::uint32_t(pos + 1), h};
+    }
+
+    void rehash(size_type capacity) {
+        m_index.assign(capacity, slot{0, 0});
+        for (size_type i = 0; i < m_entries.size(); i++)
+            insert_slot(i, hash(m_entries[i].first));
+    }
+
+    // add the last member to the index, build the index if needed
+    void index_last() {
+        if (m_index.empty()) {
+            if (m_entries.size() > linear_limit)
+                rehash(index_capacity(m_entries.size()));
+        } else if (2 * m_entries.size() > m_index.size()) {
+            rehash(2 * m_index.size());
+        } else {
+            insert_slot(m_entries.size() - 1, hash(m_entries.back().first));
+        }
+    }
+
+    // remove slot i, shift the following probe sequence back
+    void erase_slot(size_type i) {
+        auto mask = m_index.size() - 1;
+        for (auto j = (i + 1) & mask; m_index[j].index != 0;
+             j = (j + 1) & mask) {
+            auto home = m_index[j].hash & mask;
+            // j may move to i if its home is not in (i, j]
+            bool keep = i <= j ? (i < home && home <= j)
+                               : (i < home || home <= j);
+            if (!keep) {
+                m_index[i] = m_index[j];
+                i = j;
+            }
+        }
+        m_index[i] = slot{0, 0};
+    }
+
+    void erase_at(size_type pos) {
+        if constexpr (KeepOrder) {
+            if (!m_index.empty()) {
+                erase_slot(find_slot(pos));
+                for (auto& i : m_index) {
+                    if (i.index > pos + 1)
+                        i.index--;
+                }
+            }
+            m_entries.erase(m_entries.begin() + pos);
+            return;
+        }
+
+        auto last = m_entries.size() - 1;
+        if (!m_index.empty()) {
+            erase_slot(find_slot(pos));
+            if (pos != last)
+                m_index[find_slot(last)].index = std::uint32_t(pos + 1);
+        }
+        if (pos != last) {
+            // the key is not const, the member can be move-assigned
+            m_entries[pos] = std::move(m_entries[last]);
+        }
+        m_entries.pop_back();
+    }
+};
+
+/***
+ * @brief hybrid_object that always iterates in insertion order
+ * @details dump() writes the members of a parsed object in the order of
+ * the input, so a document survives parse() + dump() byte for byte (up to
+ * whitespace, escapes and number formatting).
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename Key, typename T,
+          typename Allocator = std::allocator<std::pair<Key, T>>>
+using ordered_object = hybrid_object<Key, T, Allocator, true>;
+} // namespace detail
+} // namespace microlife
@@ -0,0 +1,159 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+
+#include <cstddef>     // size_t
+#include <cstring>     // strlen
+#include <iterator>    // iterator_traits
+#include <memory>      // addressof
+#include <string>      // string
+#include <string_view> // string_view
+#include <type_traits> // is_same
+#include <vector>      // vector
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief input adapter for contiguous memory
+ * @details Reads the characters of [first, last) through a raw pointer.
+ * Used for C strings, std::string, std::string_view, std::vector<char> and
+ * every other contiguous range, nothing is copied.
+ * get_character() returns '\0' at the end of the input.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class contiguous_input_adapter {
+public:
+    using char_t = char;
+
+private:
+    const char_t* m_cur = nullptr; // the next character
+    const char_t* m_end = nullptr;
+
+public:
+    contiguous_input_adapter() = default;
+    contiguous_input_adapter(const char_t* first, const char_t* last)
+        : m_cur(first), m_end(last) {
+        json_assert(first <= last);
+    }
+
+    inline char_t get_character() {
+        return m_cur == m_end ? '\0' : *m_cur++;
+    }
+
+    // the next character
+    const char_t* position() const { return m_cur; }
+    const char_t* end() const { return m_end; }
+
+    // consume the characters before p
+    void skip_to(const char_t* p) {
+        json_assert(m_cur <= p && p <= m_end);
+        m_cur = p;
+    }
+};
+
+/***
+ * @brief input adapter for an iterator pair
+ * @details Reads one character per increment, used for ranges that are not
+ * contiguous (std::list<char>, std::istreambuf_iterator<char>, ...).
+ * get_character() returns '\0' at the end of the input.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename IteratorType>
+class iterator_input_adapter {
+public:
+    using char_t = char;
+
+    static_assert(
+        sizeof(typename std::iterator_traits<IteratorType>::value_type) == 1,
+        "iterator_input_adapter: the iterator must point to a char type");
+
+private:
+    IteratorType m_cur; // the next character
+    IteratorType m_end;
+
+public:
+    iterator_input_adapter(IteratorType first, IteratorType last)
+        : m_cur(std::move(first)), m_end(std::move(last)) {}
+
+    inline char_t get_character() {
+        if (m_cur == m_end)
+            return '\0';
+        auto ch = static_cast<char_t>(*m_cur);
+        ++m_cur;
+        return ch;
+    }
+};
+
+// whether [first, last) of IteratorType is contiguous memory of chars
+template <typename IteratorType>
+struct is_contiguous_char_iterator {
+private:
+    using value_type = std::remove_cv_t<
+        typename std::iterator_traits<IteratorType>::value_type>;
+
+    static constexpr bool is_char =
+        std::is_same_v<value_type, char> ||
+        std::is_same_v<value_type, signed char> ||
+        std::is_same_v<value_type, unsigned char>;
+
+public:
+    static constexpr bool value =
+        is_char && (std::is_pointer_v<IteratorType> ||
+                    std::is_same_v<IteratorType, std::string::iterator> ||
+                    std::is_same_v<IteratorType, std::string::const_iterator> ||
+                    std::is_same_v<IteratorType,
+                                   std::string_view::const_iterator> ||
+                    std::is_same_v<IteratorType,
+                                   typename std::vector<value_type>::iterator> ||
+                    std::is_same_v<IteratorType, typename std::vector<
+                                                     value_type>::const_iterator>);
+};
+
+// C string, up to the first null byte
+inline contiguous_input_adapter input_adapter(const char* str) {
+    json_assert(str != nullptr);
+    return contiguous_input_adapter(str, str + std::strlen(str));
+}
+
+// pointer and length
+inline contiguous_input_adapter input_adapter(const char* str,
+                                              std::size_t len) {
+    json_assert(str != nullptr || len == 0);
+    return contiguous_input_adapter(str, str + len);
+}
+
+// iterator pair, contiguous ranges are read through a raw pointer
+template <typename IteratorType>
+auto input_adapter(IteratorType first, IteratorType last) {
+    if constexpr (is_contiguous_char_iterator<IteratorType>::value) {
+        if (first == last)
+            return contiguous_input_adapter();
+        auto* p = reinterpret_cast<const char*>(std::addressof(*first));
+        return contiguous_input_adapter(p, p + (last - first));
+    } else {
+        return iterator_input_adapter<IteratorType>(std::move(first),
+                                                    std::move(last));
+    }
+}
+
+// std::string, std::string_view, std::vector<char>, std::array<char, N> ...
+template <typename ContainerType,
+          typename = decltype(std::begin(std::declval<ContainerType&>()),
+                              std::end(std::declval<ContainerType&>()))>
+auto input_adapter(const ContainerType& container) {
+    return input_adapter(std::begin(container), std::end(container));
+}
+
+// already an input adapter
+inline contiguous_input_adapter input_adapter(contiguous_input_adapter a) {
+    return a;
+}
+
+template <typename IteratorType>
+iterator_input_adapter<IteratorType>
+input_adapter(iterator_input_adapter<IteratorType> a) {
+    return a;
+}
+} // namespace detail
+} // namespace microlife
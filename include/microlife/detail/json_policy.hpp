@@ -0,0 +1,197 @@
+#pragma once
+#include "hybrid_object.hpp"
+#include "json_storage.hpp"
+#include "key_table.hpp"
+#include "shaped_object.hpp"
+
+#include <cstdint>         // int64_t, uint64_t
+#include <functional>      // less
+#include <map>             // map
+#include <memory>          // allocator
+#include <memory_resource> // polymorphic_allocator
+#include <string>          // string
+#include <type_traits>     // is_empty
+#include <vector>          // vector
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief default policy of basic_json
+ * @details basic_json<Policy> takes its value types and its allocator from
+ * a policy struct. To customize one of them, derive from json_policy and
+ * redeclare only that alias, e.g.
+ *     struct my_policy : json_policy {
+ *         using number_t = long double;
+ *     };
+ *     using my_json = basic_json<my_policy>;
+ * The strings, arrays and objects owned by a value are allocated with
+ * allocator_type, the containers should use the same allocator so that
+ * their elements can share it.
+ * @author qingl
+ * @date 2026_10_17
+ */
+struct json_policy {
+    using boolean_t = bool;
+    using number_t = double;
+    // integers without fraction or exponent, parsed and dumped exactly
+    using number_integer_t = std::int64_t;
+    using number_unsigned_t = std::uint64_t;
+    using string_t = std::string;
+
+    template <typename BasicJsonType>
+    using array_t = std::vector<BasicJsonType>;
+
+    // std::less<>: find() by std::string_view without a temporary string_t
+    template <typename BasicJsonType>
+    using object_t = std::map<string_t, BasicJsonType, std::less<>>;
+
+    using allocator_type = std::allocator<char>;
+
+    // layout of a node, see json_storage.hpp
+    template <typename JsonValue>
+    using storage_t = tagged_storage<JsonValue>;
+
+    // false: a string value is a heap allocated string_t, get<string_t&>()
+    // works. true: it is a string_buffer (or inline in the node, if the
+    // storage allows it), only readable as a copy or a std::string_view
+    static constexpr bool small_strings = false;
+};
+
+/***
+ * @brief basic_json policy allocating from a std::pmr::memory_resource
+ * @details Every string, array, object and element storage of a value comes
+ * from the memory resource of its allocator. Elements inherit the resource
+ * of their container (uses-allocator construction), so a whole tree built
+ * by parse() lives in the resource given to the root.
+ * @author qingl
+ * @date 2026_10_17
+ */
+struct pmr_json_policy : json_policy {
+    using string_t = std::pmr::string;
+
+    template <typename BasicJsonType>
+    using array_t = std::pmr::vector<BasicJsonType>;
+
+    template <typename BasicJsonType>
+    using object_t = std::pmr::map<string_t, BasicJsonType, std::less<>>;
+
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+};
+
+/***
+ * @brief basic_json policy storing every value in 8 bytes (NaN-boxing)
+ * @details Numbers are kept as doubles, null / boolean / string / array /
+ * object and integers of up to 48 bits are tagged payloads in the NaN
+ * space (see nan_boxed_storage). Larger integers take an allocation of
+ * 8 bytes, like strings, and stay exact.
+ * Halves the size of a node compared to json_policy, a number array is
+ * then a plain array of doubles in memory. Needs 64 bit pointers with at
+ * most 48 significant bits.
+ * @author qingl
+ * @date 2026_10_17
+ */
+struct compact_json_policy : json_policy {
+    template <typename JsonValue>
+    using storage_t = nan_boxed_storage<JsonValue>;
+};
+
+/***
+ * @brief basic_json policy with the small string optimization
+ * @details Strings of up to 14 bytes are stored inside the 16 byte node,
+ * longer strings take one allocation (size + characters) instead of a
+ * string_t object plus its buffer. Read them with get<std::string_view>().
+ * @author qingl
+ * @date 2026_10_17
+ */
+struct small_string_json_policy : json_policy {
+    template <typename JsonValue>
+    using storage_t = small_string_storage<JsonValue>;
+
+    static constexpr bool small_strings = true;
+};
+
+/***
+ * @brief basic_json policy storing objects in a hybrid_object
+ * @details Small objects are a flat vector of members searched linearly,
+ * large ones get a hash index (see hybrid_object.hpp). Members are not
+ * sorted: dump() writes them in insertion order until a member is erased.
+ * @author qingl
+ * @date 2026_10_17
+ */
+struct hybrid_object_json_policy : json_policy {
+    template <typename BasicJsonType>
+    using object_t = hybrid_object<string_t, BasicJsonType>;
+};
+
+/***
+ * @brief basic_json policy keeping the members of objects in input order
+ * @details Objects are ordered_object: flat vector + hash index like
+ * hybrid_object_json_policy, but erasing a member keeps the order.
+ * parse() + dump() reproduce the order of the members of the input.
+ * @author qingl
+ * @date 2026_10_17
+ */
+struct ordered_json_policy : json_policy {
+    template <typename BasicJsonType>
+    using object_t = ordered_object<string_t, BasicJsonType>;
+};
+
+/***
+ * @brief ordered objects whose keys are interned
+ * @details Every key is stored once in key_table::global(), the members
+ * hold a pointer to it (interned_key) instead of a string_t. For streams
+ * of records with the same keys this removes one allocation per member
+ * and the key bytes from every object; looking up an interned_key
+ * compares addresses. The table only grows, use it for documents whose
+ * keys come from a bounded set.
+ * @author qingl
+ * @date 2026_10_17
+ */
+struct interned_json_policy : json_policy {
+    template <typename BasicJsonType>
+    using object_t = ordered_object<interned_key, BasicJsonType>;
+};
+
+/***
+ * @brief objects sharing their key lists (hidden classes)
+ * @details Objects with the same keys in the same order, e.g. the rows of
+ * an array of records, share one object_shape (interned keys + index) and
+ * only store a vector of values, see shaped_object. Lookups through a
+ * member_key reuse the slot found in the previous object of the same
+ * shape.
+ * @author qingl
+ * @date 2026_10_17
+ */
+struct shaped_json_policy : json_policy {
+    template <typename BasicJsonType>
+    using object_t = shaped_object<BasicJsonType>;
+};
+
+/***
+ * @brief stores an allocator, takes no space if the allocator is empty
+ * @details base class of basic_json (empty base optimization).
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename Allocator, bool = std::is_empty_v<Allocator>>
+class allocator_holder {
+public:
+    allocator_holder() = default;
+    explicit allocator_holder(const Allocator&) {}
+
+    Allocator get_allocator() const { return Allocator(); }
+};
+
+template <typename Allocator>
+class allocator_holder<Allocator, false> {
+private:
+    Allocator m_allocator;
+
+public:
+    allocator_holder() = default;
+    explicit allocator_holder(const Allocator& a) : m_allocator(a) {}
+
+    Allocator get_allocator() const { return m_allocator; }
+};
+} // namespace detail
+} // namespace microlife
@@ -0,0 +1,263 @@
+#pragma once
+#include "key_table.hpp"   // key_cache, is_interned_key
+#include "macro_scope.hpp" // json_assert()
+
+#include <string_view> // string_view
+#include <type_traits> // conditional, declval, void_t
+#include <vector>      // vector
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief SAX interface
+ * @details The parser reports every JSON value as an event instead of
+ * building a tree. Each event returns whether parsing should continue, so
+ * a handler can stop early by returning false.
+ * Any class that provides these member functions can be used with
+ * parser::sax_parse(), inheriting from json_sax is optional.
+ * number_integer() and number_unsigned() are optional for such a class:
+ * without them integers are reported to number() as doubles.
+ * A class may also provide `bool raw_numbers() const` and
+ * `bool number_text(std::string_view)`: when raw_numbers() returns true at
+ * the start of the parse, every number is only validated and its text is
+ * reported to number_text() instead (the view is valid during the call).
+ * In the same way `bool raw_strings() const`,
+ * `bool string_text(std::string_view, bool escaped)` and
+ * `bool key_text(std::string_view, bool escaped)` receive the text between
+ * the quotes of strings and keys, a view into a contiguous input, escapes
+ * not decoded (see lexer::unescape()).
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename JsonType>
+struct json_sax {
+    using basic_json = JsonType;
+    using boolean_t = typename basic_json::boolean_t;
+    using number_t = typename basic_json::number_t;
+    using number_integer_t = typename basic_json::number_integer_t;
+    using number_unsigned_t = typename basic_json::number_unsigned_t;
+    using string_t = typename basic_json::string_t;
+
+    // a null value
+    virtual bool null() = 0;
+
+    // a boolean value
+    virtual bool boolean(boolean_t val) = 0;
+
+    // a number value with a fraction or an exponent (or too large for
+    // the integer types)
+    virtual bool number(number_t val) = 0;
+
+    // an integer that fits number_integer_t, reported as a double unless
+    // overridden
+    virtual bool number_integer(number_integer_t val) {
+        return number(number_t(val));
+    }
+
+    // an integer above the range of number_integer_t
+    virtual bool number_unsigned(number_unsigned_t val) {
+        return number(number_t(val));
+    }
+
+    // a string value, the handler may move from val
+    virtual bool string(string_t& val) = 0;
+
+    // the beginning of an object `{`
+    virtual bool start_object() = 0;
+
+    // an object key, the handler may move from val
+    virtual bool key(string_t& val) = 0;
+
+    // the end of an object `}`
+    virtual bool end_object() = 0;
+
+    // the beginning of an array `[`
+    virtual bool start_array() = 0;
+
+    // the end of an array `]`
+    virtual bool end_array() = 0;
+
+    virtual ~json_sax() = default;
+};
+
+// SAX has number_integer(Integer) / number_unsigned(Unsigned)
+template <typename SAX, typename Integer, typename = void>
+struct has_number_integer : std::false_type {};
+
+template <typename SAX, typename Integer>
+struct has_number_integer<
+    SAX, Integer,
+    std::void_t<decltype(std::declval<SAX&>().number_integer(
+        std::declval<Integer>()))>> : std::true_type {};
+
+template <typename SAX, typename Unsigned, typename = void>
+struct has_number_unsigned : std::false_type {};
+
+template <typename SAX, typename Unsigned>
+struct has_number_unsigned<
+    SAX, Unsigned,
+    std::void_t<decltype(std::declval<SAX&>().number_unsigned(
+        std::declval<Unsigned>()))>> : std::true_type {};
+
+// SAX has raw_numbers() and number_text(std::string_view)
+template <typename SAX, typename = void>
+struct has_number_text : std::false_type {};
+
+template <typename SAX>
+struct has_number_text<
+    SAX, std::void_t<decltype(std::declval<const SAX&>().raw_numbers()),
+                     decltype(std::declval<SAX&>().number_text(
+                         std::declval<std::string_view>()))>>
+    : std::true_type {};
+
+// SAX has raw_strings(), string_text() and key_text()
+template <typename SAX, typename = void>
+struct has_string_text : std::false_type {};
+
+template <typename SAX>
+struct has_string_text<
+    SAX, std::void_t<decltype(std::declval<const SAX&>().raw_strings()),
+                     decltype(std::declval<SAX&>().string_text(
+                         std::declval<std::string_view>(), true)),
+                     decltype(std::declval<SAX&>().key_text(
+                         std::declval<std::string_view>(), true))>>
+    : std::true_type {};
+
+/***
+ * @brief SAX handler that builds a basic_json tree
+ * @details Every array element and object member is constructed directly in
+ * its final slot of the parent container. The handler only keeps a stack of
+ * pointers to the containers that are still open, the stack keeps its
+ * capacity between two reset() calls.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename JsonType>
+class json_sax_dom_parser {
+public:
+    using basic_json = JsonType;
+    using boolean_t = typename basic_json::boolean_t;
+    using number_t = typename basic_json::number_t;
+    using number_integer_t = typename basic_json::number_integer_t;
+    using number_unsigned_t = typename basic_json::number_unsigned_t;
+    using string_t = typename basic_json::string_t;
+    using array_t = typename basic_json::array_t;
+    using object_t = typename basic_json::object_t;
+    using value_t = typename basic_json::value_t;
+
+private:
+    static constexpr bool interned_keys =
+        is_interned_key<typename object_t::key_type>::value;
+    struct no_key_cache {};
+
+    basic_json* m_root = nullptr;     // the value being built
+    basic_json* m_member = nullptr;   // slot of the current object member
+    std::vector<basic_json*> m_stack; // open arrays/objects, innermost last
+    // interned keys already looked up by this parser
+    std::conditional_t<interned_keys, key_cache, no_key_cache> m_keys;
+
+public:
+    json_sax_dom_parser() = default;
+    explicit json_sax_dom_parser(basic_json& root) : m_root(&root) {}
+
+    // build the next tree into root
+    void reset(basic_json& root) {
+        m_root = &root;
+        m_member = nullptr;
+        m_stack.clear();
+    }
+
+    bool null() {
+        handle_value(nullptr);
+        return true;
+    }
+
+    bool boolean(boolean_t val) {
+        handle_value(val);
+        return true;
+    }
+
+    bool number(number_t val) {
+        handle_value(val);
+        return true;
+    }
+
+    bool number_integer(number_integer_t val) {
+        handle_value(val);
+        return true;
+    }
+
+    bool number_unsigned(number_unsigned_t val) {
+        handle_value(val);
+        return true;
+    }
+
+    bool string(string_t& val) {
+        handle_value(std::move(val));
+        return true;
+    }
+
+    bool start_object() {
+        m_stack.push_back(handle_value(value_t::object));
+        return true;
+    }
+
+    bool key(string_t& val) {
+        json_assert(!m_stack.empty() && m_stack.back()->is_object());
+        // https://stackoverflow.com/questions/7397934/
+        // calling-template-function-within-template-class
+        // a duplicated key keeps the last value
+        auto& object = m_stack.back()->template get<object_t&>();
+        if constexpr (interned_keys) {
+            // val is not moved from, the lexer keeps its buffer
+            m_member = &object[m_keys.intern(val)];
+        } else {
+            m_member = &object[std::move(val)];
+        }
+        return true;
+    }
+
+    bool end_object() {
+        json_assert(!m_stack.empty() && m_stack.back()->is_object());
+        m_stack.pop_back();
+        return true;
+    }
+
+    bool start_array() {
+        m_stack.push_back(handle_value(value_t::array));
+        return true;
+    }
+
+    bool end_array() {
+        json_assert(!m_stack.empty() && m_stack.back()->is_array());
+        m_stack.pop_back();
+        return true;
+    }
+
+private:
+    // write a value to its slot, return the slot
+    // values use the allocator of their slot, arrays pass theirs to the new
+    // element
+    template <typename Value>
+    basic_json* handle_value(Value&& v) {
+        json_assert(m_root != nullptr);
+
+        if (m_stack.empty()) {
+            *m_root =
+                basic_json(std::forward<Value>(v), m_root->get_allocator());
+            return m_root;
+        }
+
+        if (m_stack.back()->is_array()) {
+            return &m_stack.back()->template get<array_t&>().emplace_back(
+                std::forward<Value>(v));
+        }
+
+        json_assert(m_member != nullptr);
+        *m_member =
+            basic_json(std::forward<Value>(v), m_member->get_allocator());
+        return m_member;
+    }
+};
+} // namespace detail
+} // namespace microlife
@@ -0,0 +1,345 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+#include "value_t.hpp"
+
+#include <cstddef>     // size_t
+#include <cstdint>     // int64_t, uint64_t, uintptr_t
+#include <cstring>     // memcpy
+#include <string_view> // string_view
+#include <type_traits> // is_same
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief storage of a basic_json node: type tag + value union
+ * @details The default layout. JsonValue is basic_json::json_value, the
+ * union of boolean, number, integers and string / array / object
+ * pointers. With 8 byte payloads the node is 16 bytes.
+ * Every storage offers the same interface, basic_json reads and writes its
+ * value only through it:
+ *     value_t type() const;
+ *     JsonValue value() const;
+ *     void set(value_t, JsonValue);
+ *     static constexpr std::size_t inline_capacity;
+ * A storage with inline_capacity > 0 keeps strings of up to that many
+ * bytes in the node itself, and provides in addition
+ *     bool is_inline_string() const;
+ *     std::string_view inline_string() const;
+ *     void set_inline_string(std::string_view);
+ * A storage with boxed_integers cannot hold every integer in the node,
+ * basic_json keeps the others in a 64 bit word it allocates (and frees),
+ * and uses in addition
+ *     static bool fits_integer(value_t, JsonValue);
+ *     void set_boxed_integer(value_t, std::uint64_t*);
+ *     std::uint64_t* boxed_integer() const; // nullptr if not boxed
+ * value() reads a boxed integer through the pointer.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename JsonValue>
+class tagged_storage {
+private:
+    value_t m_type = value_t::null;
+    JsonValue m_value;
+
+public:
+    static constexpr std::size_t inline_capacity = 0;
+    static constexpr bool boxed_integers = false;
+
+    tagged_storage() noexcept { m_value.object = nullptr; }
+    tagged_storage(value_t t, JsonValue v) noexcept : m_type(t), m_value(v) {}
+
+    value_t type() const noexcept { return m_type; }
+    JsonValue value() const noexcept { return m_value; }
+
+    // where a number value keeps its number_t (see number_span)
+    const unsigned char* number_bytes() const noexcept {
+        return reinterpret_cast<const unsigned char*>(&m_value.number);
+    }
+
+    void set(value_t t, JsonValue v) noexcept {
+        m_type = t;
+        m_value = v;
+    }
+};
+
+/***
+ * @brief NaN-boxed storage of a basic_json node, 8 bytes
+ * @details A number is stored as the bits of its double. Every other value
+ * is hidden in the NaN space the parser never produces: the top 13 bits
+ * are all set, bits 48..50 hold the value_t, the low 48 bits hold the
+ * payload (the boolean, the string / array / object pointer, or an
+ * integer in 48 bits, two's complement for number_integer).
+ *     number   any double, NaN is canonicalized to 0x7FF8000000000000
+ *     other    1111 1111 1111 1ttt pppp ... pppp (48 bit payload)
+ * An integer that needs more than 48 bits is boxed: the payload is a
+ * pointer to the 64 bit word holding it, with the tag of a number (never
+ * used by other boxed values) and bit 0 set for number_unsigned.
+ * Requires number_t = double and pointers of at most 48 significant bits
+ * (x86-64 and AArch64 user space).
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename JsonValue>
+class nan_boxed_storage {
+private:
+    using string_pointer = decltype(JsonValue::string);
+    using array_pointer = decltype(JsonValue::array);
+    using object_pointer = decltype(JsonValue::object);
+
+    static_assert(std::is_same_v<decltype(JsonValue::number), double>,
+                  "nan_boxed_storage requires number_t = double");
+    static_assert(sizeof(void*) == 8, "nan_boxed_storage requires 64 bits");
+
+    static constexpr std::uint64_t box_mask = 0xFFF8000000000000ull;
+    static constexpr std::uint64_t payload_mask = 0x0000FFFFFFFFFFFFull;
+    static constexpr std::uint64_t canonical_nan = 0x7FF8000000000000ull;
+    static constexpr int tag_shift = 48;
+    // integers in [-2^47, 2^47) / [0, 2^48) fit in the payload
+    static constexpr std::int64_t integer_limit = std::int64_t(1) << 47;
+
+    std::uint64_t m_bits = box(value_t::null, 0);
+
+    static constexpr std::uint64_t box(value_t t, std::uint64_t payload) {
+        return box_mask | (std::uint64_t(t) << tag_shift) | payload;
+    }
+
+    template <typename Pointer>
+    static std::uint64_t box_pointer(value_t t, Pointer p) {
+        auto bits = std::uint64_t(reinterpret_cast<std::uintptr_t>(p));
+        json_assert((bits & ~payload_mask) == 0);
+        return box(t, bits);
+    }
+
+    template <typename Pointer>
+    Pointer unbox_pointer() const {
+        return reinterpret_cast<Pointer>(
+            std::uintptr_t(m_bits & payload_mask));
+    }
+
+    bool is_number() const noexcept {
+        return (m_bits & box_mask) != box_mask;
+    }
+
+    value_t boxed_type() const noexcept {
+        return value_t((m_bits >> tag_shift) & 7);
+    }
+
+    void set_double(double d) noexcept {
+        if (d != d) {
+            m_bits = canonical_nan;
+        } else {
+            std::memcpy(&m_bits, &d, sizeof(m_bits));
+        }
+    }
+
+public:
+    static constexpr std::size_t inline_capacity = 0;
+    static constexpr bool boxed_integers = true;
+
+    nan_boxed_storage() noexcept = default;
+    nan_boxed_storage(value_t t, JsonValue v) noexcept { set(t, v); }
+
+    value_t type() const noexcept {
+        if (is_number())
+            return value_t::number;
+        auto t = boxed_type();
+        if (t == value_t::number) // a boxed integer
+            return (m_bits & 1) ? value_t::number_unsigned
+                                : value_t::number_integer;
+        return t;
+    }
+
+    // the integer v of type t fits in the payload
+    static bool fits_integer(value_t t, JsonValue v) noexcept {
+        if (t == value_t::number_integer)
+            return v.integer >= -integer_limit && v.integer < integer_limit;
+        return v.unsigned_integer <= payload_mask;
+    }
+
+    // an integer that does not fit, p: its 64 bits
+    void set_boxed_integer(value_t t, std::uint64_t* p) noexcept {
+        json_assert(t == value_t::number_integer ||
+                    t == value_t::number_unsigned);
+        json_assert((reinterpret_cast<std::uintptr_t>(p) & 1) == 0);
+        m_bits = box_pointer(value_t::number, p) |
+                 (t == value_t::number_unsigned ? 1 : 0);
+    }
+
+    std::uint64_t* boxed_integer() const noexcept {
+        if (is_number() || boxed_type() != value_t::number)
+            return nullptr;
+        return reinterpret_cast<std::uint64_t*>(
+            std::uintptr_t(m_bits & payload_mask & ~std::uint64_t(1)));
+    }
+
+    // a number value is the double itself (see number_span)
+    const unsigned char* number_bytes() const noexcept {
+        return reinterpret_cast<const unsigned char*>(&m_bits);
+    }
+
+    JsonValue value() const noexcept {
+        JsonValue v;
+        if (is_number()) {
+            std::memcpy(&v.number, &m_bits, sizeof(m_bits));
+            return v;
+        }
+        switch (type()) {
+        case value_t::boolean:
+            v.boolean = (m_bits & 1) != 0;
+            break;
+        case value_t::string:
+            v.string = unbox_pointer<string_pointer>();
+            break;
+        case value_t::array:
+            v.array = unbox_pointer<array_pointer>();
+            break;
+        case value_t::object:
+            v.object = unbox_pointer<object_pointer>();
+            break;
+        case value_t::number_integer:
+            if (auto* p = boxed_integer())
+                v.integer = std::int64_t(*p);
+            else // sign extension of the 48 bit payload
+                v.integer = std::int64_t(m_bits << (64 - tag_shift)) >>
+                            (64 - tag_shift);
+            break;
+        case value_t::number_unsigned:
+            if (auto* p = boxed_integer())
+                v.unsigned_integer = *p;
+            else
+                v.unsigned_integer = m_bits & payload_mask;
+            break;
+        default:
+            v.object = nullptr;
+            break;
+        }
+        return v;
+    }
+
+    void set(value_t t, JsonValue v) noexcept {
+        switch (t) {
+        case value_t::number:
+            set_double(v.number);
+            break;
+        // larger integers go through set_boxed_integer()
+        case value_t::number_integer:
+            json_assert(fits_integer(t, v));
+            m_bits = box(t, std::uint64_t(v.integer) & payload_mask);
+            break;
+        case value_t::number_unsigned:
+            json_assert(fits_integer(t, v));
+            m_bits = box(t, v.unsigned_integer);
+            break;
+        case value_t::boolean:
+            m_bits = box(t, v.boolean ? 1 : 0);
+            break;
+        case value_t::string:
+            m_bits = box_pointer(t, v.string);
+            break;
+        case value_t::array:
+            m_bits = box_pointer(t, v.array);
+            break;
+        case value_t::object:
+            m_bits = box_pointer(t, v.object);
+            break;
+        default:
+            m_bits = box(value_t::null, 0);
+            break;
+        }
+    }
+};
+
+/***
+ * @brief tagged storage keeping short strings inside the 16 byte node
+ * @details Byte 0 is the tag, bytes 8..15 the JsonValue. An inline string
+ * has its own tag, its size in byte 1 and its characters in bytes 2..15,
+ * so strings of up to 14 bytes need no allocation at all.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename JsonValue>
+class small_string_storage {
+public:
+    static constexpr std::size_t inline_capacity = 14;
+    static constexpr bool boxed_integers = false;
+
+private:
+    static constexpr std::uint8_t inline_string_tag = 0x80;
+    static constexpr std::size_t value_offset = 8;
+
+    static_assert(sizeof(JsonValue) <= 16 - value_offset,
+                  "small_string_storage requires an 8 byte JsonValue");
+
+    alignas(8) unsigned char m_bytes[16] = {};
+
+    std::uint8_t tag() const noexcept { return m_bytes[0]; }
+
+public:
+    small_string_storage() noexcept = default;
+    small_string_storage(value_t t, JsonValue v) noexcept { set(t, v); }
+
+    value_t type() const noexcept {
+        return tag() == inline_string_tag ? value_t::string : value_t(tag());
+    }
+
+    JsonValue value() const noexcept {
+        JsonValue v;
+        std::memcpy(&v, m_bytes + value_offset, sizeof(v));
+        return v;
+    }
+
+    // where a number value keeps its number_t (see number_span)
+    const unsigned char* number_bytes() const noexcept {
+        return m_bytes + value_offset;
+    }
+
+    void set(value_t t, JsonValue v) noexcept {
+        m_bytes[0] = std::uint8_t(t);
+        std::memcpy(m_bytes + value_offset, &v, sizeof(v));
+    }
+
+    bool is_inline_string() const noexcept {
+        return tag() == inline_string_tag;
+    }
+
+    std::string_view inline_string() const noexcept {
+        return std::string_view(reinterpret_cast<const char*>(m_bytes + 2),
+                                m_bytes[1]);
+    }
+
+    void set_inline_string(std::string_view str) noexcept {
+        json_assert(str.size() <= inline_capacity);
+        m_bytes[0] = inline_string_tag;
+        m_bytes[1] = std::uint8_t(str.size());
+        if (!str.empty())
+            std::memcpy(m_bytes + 2, str.data(), str.size());
+    }
+};
+
+/***
+ * @brief heap string of a basic_json with small_strings: one allocation
+ * @details The size is followed directly by the characters (no null
+ * byte), instead of a string_t object which allocates again.
+ * @author qingl
+ * @date 2026_10_17
+ */
+struct string_buffer {
+    std::size_t size;
+
+    char* data() noexcept { return reinterpret_cast<char*>(this + 1); }
+    const char* data() const noexcept {
+        return reinterpret_cast<const char*>(this + 1);
+    }
+
+    std::string_view view() const noexcept {
+        return std::string_view(data(), size);
+    }
+
+    // number of string_buffer units holding a string of size bytes
+    static constexpr std::size_t units(std::size_t size) noexcept {
+        return 1 + (size + sizeof(string_buffer) - 1) / sizeof(string_buffer);
+    }
+};
+} // namespace detail
+} // namespace microlife
@@ -0,0 +1,166 @@
+#pragma once
+#include "arena.hpp"        // arena
+#include "json_storage.hpp" // string_buffer
+
+#include <cstddef>       // size_t
+#include <cstring>       // memcpy
+#include <mutex>         // unique_lock
+#include <shared_mutex>  // shared_mutex, shared_lock
+#include <string_view>   // string_view
+#include <type_traits>   // false_type, true_type
+#include <unordered_map> // unordered_map
+#include <unordered_set> // unordered_set
+
+namespace microlife {
+namespace detail {
+class key_table;
+
+/***
+ * @brief handle of a string stored once in a key_table
+ * @details One pointer wide. Two handles of the same table are equal iff
+ * they point to the same string, so == is a pointer comparison. The
+ * string is read through the implicit conversion to std::string_view.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class interned_key {
+private:
+    const string_buffer* m_buffer;
+
+    friend class key_table;
+    explicit interned_key(const string_buffer* buffer) : m_buffer(buffer) {}
+
+public:
+    // interns str into key_table::global()
+    explicit interned_key(std::string_view str);
+
+    const char* data() const noexcept { return m_buffer->data(); }
+    std::size_t size() const noexcept { return m_buffer->size; }
+
+    operator std::string_view() const noexcept { return m_buffer->view(); }
+
+    friend bool operator==(interned_key lhs, interned_key rhs) noexcept {
+        return lhs.m_buffer == rhs.m_buffer;
+    }
+    friend bool operator!=(interned_key lhs, interned_key rhs) noexcept {
+        return lhs.m_buffer != rhs.m_buffer;
+    }
+};
+
+/***
+ * @brief thread-safe set of interned strings
+ * @details Every distinct string is copied once into an arena, as a
+ * string_buffer, and stays there until the table is destroyed; intern()
+ * returns the same handle for the same characters. Lookups take a shared
+ * lock, only a string seen for the first time takes the exclusive one.
+ * global() is the table used by interned_json, it lives until the end of
+ * the program, so a stream of documents with the same few keys stores each
+ * key once in total instead of once per object.
+ * Interned strings are never freed: intern keys, not arbitrary values.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class key_table {
+private:
+    mutable std::shared_mutex m_mutex;
+    arena m_arena;
+    std::unordered_set<std::string_view> m_strings; // views into m_arena
+
+public:
+    key_table() = default;
+    key_table(const key_table&) = delete;
+    key_table& operator=(const key_table&) = delete;
+
+    // the table shared by every interned_json
+    static key_table& global() {
+        static key_table table;
+        return table;
+    }
+
+    interned_key intern(std::string_view str) {
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            auto it = m_strings.find(str);
+            if (it != m_strings.end())
+                return handle(*it);
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_strings.find(str);
+        if (it != m_strings.end())
+            return handle(*it);
+
+        auto* buffer = m_arena.allocate_array<string_buffer>(
+            string_buffer::units(str.size()));
+        buffer->size = str.size();
+        if (!str.empty())
+            std::memcpy(buffer->data(), str.data(), str.size());
+        m_strings.insert(buffer->view());
+        return interned_key(buffer);
+    }
+
+    // number of distinct strings
+    std::size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_strings.size();
+    }
+
+    // bytes of the stored strings (with their sizes)
+    std::size_t memory_usage() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_arena.used();
+    }
+
+private:
+    // the buffer holding the characters of str
+    static interned_key handle(std::string_view str) noexcept {
+        auto* data = reinterpret_cast<const string_buffer*>(str.data());
+        return interned_key(data - 1);
+    }
+};
+
+inline interned_key::interned_key(std::string_view str)
+    : interned_key(key_table::global().intern(str)) {}
+
+/***
+ * @brief per-parser cache in front of a key_table
+ * @details Owned by one parser (see json_sax_dom_parser), so it needs no
+ * lock: a key seen before is resolved by a hash lookup, without touching
+ * the mutex of the shared table. Caches at most max_cached keys, the
+ * others go to the table each time.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class key_cache {
+public:
+    static constexpr std::size_t max_cached = 4096;
+
+private:
+    key_table* m_table;
+    // the views point into m_table
+    std::unordered_map<std::string_view, interned_key> m_keys;
+
+public:
+    explicit key_cache(key_table& table = key_table::global())
+        : m_table(&table) {}
+
+    interned_key intern(std::string_view str) {
+        auto it = m_keys.find(str);
+        if (it != m_keys.end())
+            return it->second;
+
+        auto key = m_table->intern(str);
+        if (m_keys.size() < max_cached)
+            m_keys.emplace(std::string_view(key), key);
+        return key;
+    }
+};
+
+// whether T is interned_key
+template <typename T>
+struct is_interned_key : std::false_type {};
+
+template <>
+struct is_interned_key<interned_key> : std::true_type {};
+} // namespace detail
+} // namespace microlife
@@ -1,44 +1,89 @@
 #pragma once
+#include "input_adapter.hpp" // contiguous_input_adapter
+#include "number_parser.hpp" // number_parser
+#include "simd.hpp" // simd::find_escape()
 #include "token_t.hpp" // token_t
+#include "value_t.hpp" // value_t
 #include "macro_scope.hpp" // json_assert()
 
-#include <errno.h>  // errno(strtod)
-#include <math.h>   // HUGE_VAL(strtod)
+#include <cstdint>     // int64_t, uint64_t, INT64_MAX
+#include <cstring>     // memchr, memmove
+#include <string_view> // string_view
+#include <type_traits> // is_same
 
 namespace microlife {
 namespace detail {
 /***
  * @brief JSON format lexer
  * @details The field type used by this class to parse strings.
+ * The characters are read through InputAdapterType (see input_adapter.hpp),
+ * contiguous inputs are read through a raw pointer.
  * @author qingl
  * @date 2022_04_09
  */
-template <typename JsonType>
+template <typename JsonType,
+          typename InputAdapterType = ::microlife::detail::contiguous_input_adapter>
 class lexer {
 private:
     using basic_json = JsonType;
     using number_t = typename basic_json::number_t;
+    using number_integer_t = typename basic_json::number_integer_t;
+    using number_unsigned_t = typename basic_json::number_unsigned_t;
     using string_t = typename basic_json::string_t;
-    using string_const_iterator = typename string_t::const_iterator;
 
+    using value_t = ::microlife::detail::value_t;
     using token_t = ::microlife::detail::token_t;
     using char_t = char;
+    using number_parser = ::microlife::detail::number_parser;
+
+    // the input can be read through a raw pointer
+    static constexpr bool is_contiguous =
+        std::is_same_v<InputAdapterType,
+                       ::microlife::detail::contiguous_input_adapter>;
+
+public:
+    using input_t = InputAdapterType;
 
 private:
-    string_const_iterator m_it_cur, m_it_end; // the next character to parse
-    char_t m_cur;                             // current character
+    InputAdapterType m_input; // the next character to parse
+    char_t m_cur;             // current character
 
     string_t m_buffer;       // parsed string value
     number_t m_value_number; // parsed number value
 
+    // the kind of the parsed number: number (m_value_number),
+    // number_integer (m_value_integer) or number_unsigned (m_value_unsigned)
+    value_t m_number_type = value_t::number;
+    number_integer_t m_value_integer = 0;
+    number_unsigned_t m_value_unsigned = 0;
+
+    // numbers are only validated, see raw_numbers()
+    bool m_raw_numbers = false;
+    std::string_view m_number_text; // the text of the parsed number
+
+    // strings are only validated, see raw_strings()
+    bool m_raw_strings = false;
+    std::string_view m_string_text; // the text between the quotes
+    bool m_string_escaped = false;  // m_string_text has an escape
+
 public:
-    // init the lexer with the given input buffer
-    void init(string_const_iterator begin, string_const_iterator end) {
-        m_it_cur = begin;
-        m_it_end = end;
+    lexer() = default;
+    explicit lexer(InputAdapterType input) : m_input(std::move(input)) {
+        next_char();
+    }
+
+    // init the lexer with the given input
+    void init(InputAdapterType input) {
+        m_input = std::move(input);
         next_char();
     }
 
+    // init the lexer with the given input buffer
+    template <typename IteratorType>
+    void init(IteratorType begin, IteratorType end) {
+        init(::microlife::detail::input_adapter(begin, end));
+    }
+
     // scan the next field, return token
     token_t scan() {
         skip_whitespace();
@@ -109,11 +154,113 @@ public:
     }
 
     // returns the value parsed by scan, assert(token == value_number)
-    number_t get_number() const { return m_value_number; }
+    // an integer is converted, see get_number_type()
+    number_t get_number() const {
+        switch (m_number_type) {
+        case value_t::number_integer:
+            return number_t(m_value_integer);
+        case value_t::number_unsigned:
+            return number_t(m_value_unsigned);
+        default:
+            return m_value_number;
+        }
+    }
+
+    // the kind of the number parsed by scan, assert(token == value_number)
+    // an integer (no fraction, no exponent) that fits std::int64_t is a
+    // number_integer, a larger one that fits std::uint64_t is a
+    // number_unsigned, everything else (and -0) is a number
+    value_t get_number_type() const { return m_number_type; }
+
+    // assert(get_number_type() == value_t::number_integer)
+    number_integer_t get_number_integer() const { return m_value_integer; }
+
+    // assert(get_number_type() == value_t::number_unsigned)
+    number_unsigned_t get_number_unsigned() const { return m_value_unsigned; }
+
+    // numbers are only validated, not converted: get_number_text() is the
+    // only valid result of a value_number token
+    void raw_numbers(bool raw) { m_raw_numbers = raw; }
+    bool raw_numbers() const { return m_raw_numbers; }
+
+    // the text of the number parsed by scan, assert(raw_numbers())
+    // valid until the next scan
+    std::string_view get_number_text() const { return m_number_text; }
 
     // returns the value parsed by scan, assert(token == value_string)
     string_t&& get_string() { return std::move(m_buffer); }
 
+    // strings are only validated, not copied: get_string_text() is the only
+    // valid result of a value_string token. Contiguous inputs only, the
+    // text is a view into the input.
+    void raw_strings(bool raw) {
+        json_assert(!raw || is_contiguous);
+        m_raw_strings = raw;
+    }
+    bool raw_strings() const { return m_raw_strings; }
+
+    // the text between the quotes of the string parsed by scan, escapes
+    // are not decoded, assert(raw_strings())
+    std::string_view get_string_text() const { return m_string_text; }
+
+    // get_string_text() has an escape sequence, see unescape()
+    bool string_escaped() const { return m_string_escaped; }
+
+    /***
+     * @brief decode the escapes of [first, last) into out
+     * @details [first, last) must be the text of a string validated by
+     * scan() (get_string_text()). The decoded string is never longer, out
+     * may be first to decode in place. Returns the end of the output.
+     */
+    static char_t* unescape(const char_t* first, const char_t* last,
+                            char_t* out) {
+        while (true) {
+            auto p = static_cast<const char_t*>(
+                std::memchr(first, '\\', std::size_t(last - first)));
+            if (p == nullptr)
+                p = last;
+            if (out != first)
+                std::memmove(out, first, std::size_t(p - first));
+            out += p - first;
+            if (p == last)
+                return out;
+
+            first = p + 2;
+            switch (p[1]) {
+            case 'b':
+                *out++ = '\b';
+                break;
+            case 'f':
+                *out++ = '\f';
+                break;
+            case 'n':
+                *out++ = '\n';
+                break;
+            case 'r':
+                *out++ = '\r';
+                break;
+            case 't':
+                *out++ = '\t';
+                break;
+            case 'u': {
+                unsigned u = hex4(first);
+                first += 4;
+                // surrogate pair, `\\uDC00`
+                if (u >= 0xD800 && u <= 0xDBFF) {
+                    unsigned u2 = hex4(first + 2);
+                    first += 6;
+                    u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
+                }
+                out = to_utf8(u, out);
+                break;
+            }
+            default: // '"', '\\'
+                *out++ = p[1];
+                break;
+            }
+        }
+    }
+
 private:
     // scan a literal, true/false/null
     inline token_t scan_literal(const char_t* literal_text,
@@ -136,9 +283,22 @@ private:
     // scan string
     token_t scan_string() {
         json_assert(m_cur == '\"');
+        if constexpr (is_contiguous) {
+            if (m_raw_strings)
+                return scan_string_text();
+        }
         m_buffer.clear();
 
         while (true) {
+            // copy the characters up to the next '"', '\\' or control
+            // character at once, only those go through the switch below
+            if constexpr (is_contiguous) {
+                const char_t* first = m_input.position();
+                const char_t* last = simd::find_escape(first, m_input.end());
+                m_buffer.append(first, last);
+                m_input.skip_to(last);
+            }
+
             next_char();
             switch (m_cur) {
             case '\0':
@@ -148,97 +308,11 @@ private:
                 next_char();
                 return token_t::value_string;
 
-            case '\\': {
+            case '\\':
                 next_char();
-                switch (m_cur) {
-                case '\"':
-                case '\\':
-                    m_buffer.push_back(m_cur);
-                    break;
-                case 'b':
-                    m_buffer.push_back('\b');
-                    break;
-                case 'f':
-                    m_buffer.push_back('\f');
-                    break;
-                case 'n':
-                    m_buffer.push_back('\n');
-                    break;
-                case 'r':
-                    m_buffer.push_back('\r');
-                    break;
-                case 't':
-                    m_buffer.push_back('\t');
-                    break;
-                case 'u': {
-                    // 解析 utf-8
-                    // 解析 4 位的 16 进制数
-                    auto parse_hex4 = [&](unsigned& u) {
-                        u = 0;
-                        for (int i = 0; i < 4; i++) {
-                            next_char();
-                            char ch = m_cur;
-                            u <<= 4;
-                            if (ch >= '0' && ch <= '9')
-                                u |= ch - '0';
-                            else if (ch >= 'A' && ch <= 'F')
-                                u |= ch - ('A' - 10);
-                            else if (ch >= 'a' && ch <= 'f')
-                                u |= ch - ('a' - 10);
-                            else
-                                return false;
-                        }
-                        return true;
-                    };
-
-                    unsigned u, u2;
-                    if (!parse_hex4(u))
-                        return token_t::parse_error;
-                    // surrogate pair
-                    if (u >= 0xD800 && u <= 0xDBFF) {
-                        // '\\' + 'u' + 4 字符
-                        next_char();
-                        if (m_cur != '\\')
-                            return token_t::parse_error;
-                        next_char();
-                        if (m_cur != 'u')
-                            return token_t::parse_error;
-
-                        if (!parse_hex4(u2) || (u2 < 0xDC00 || u2 > 0xDFFF))
-                            return token_t::parse_error;
-
-                        u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
-                    }
-                    // 为什么要做 x & 0xFF 这种操作呢？
-                    // 这是因为 u 是 unsigned
-                    // 类型，一些编译器可能会警告这个转型可能会截断数据。
-                    // 但实际上，配合了范围的检测然后右移之后，可以保证写入的是
-                    // 0~255 内的值。 为了避免一些编译器的警告误判，我们加上 x &
-                    // 0xFF。
-                    // 一般来说，编译器在优化之后，这与操作是会被消去的，不会影响性能。
-                    if (u <= 0x7F)
-                        m_buffer.push_back(u & 0xFF);
-                    else if (u <= 0x7FF) {
-                        m_buffer.push_back(0xC0 | ((u >> 6) & 0xFF));
-                        m_buffer.push_back(0x80 | (u & 0x3F));
-                    } else if (u <= 0xFFFF) {
-                        m_buffer.push_back(0xE0 | ((u >> 12) & 0xFF));
-                        m_buffer.push_back(0x80 | ((u >> 6) & 0x3F));
-                        m_buffer.push_back(0x80 | (u & 0x3F));
-                    } else {
-                        json_assert(u <= 0x10FFFF);
-                        m_buffer.push_back(0xF0 | ((u >> 18) & 0xFF));
-                        m_buffer.push_back(0x80 | ((u >> 12) & 0x3F));
-                        m_buffer.push_back(0x80 | ((u >> 6) & 0x3F));
-                        m_buffer.push_back(0x80 | (u & 0x3F));
-                    }
-                    break;
-                }
-                default:
+                if (!scan_escape<true>())
                     return token_t::parse_error;
-                }
                 break;
-            }
 
             default:
                 if ((unsigned char)m_cur < 0x20) {
@@ -250,73 +324,396 @@ private:
         }
     }
 
-    // 使用标准库的 strtod() 来进行转换
-    // strtod() 可转换 JSON 所要求的格式，但问题是，一些 JSON 不容许的格式
-    // strtod() 也可转换，所以我们需要自行做格式校验。
-    // strtod() https://en.cppreference.com/w/c/string/byte/strtof
+    // raw_strings(): 只校验，记录引号之间的原文，不复制也不解码
+    token_t scan_string_text() {
+        const char_t* first = m_input.position();
+        m_string_escaped = false;
+        while (true) {
+            m_input.skip_to(simd::find_escape(m_input.position(),
+                                              m_input.end()));
+            next_char();
+            switch (m_cur) {
+            case '\0':
+                return token_t::parse_error; // 缺失右引号 '"'
+
+            case '\"':
+                m_string_text = std::string_view(
+                    first, std::size_t(m_input.position() - 1 - first));
+                next_char();
+                return token_t::value_string;
+
+            case '\\':
+                m_string_escaped = true;
+                next_char();
+                if (!scan_escape<false>())
+                    return token_t::parse_error;
+                break;
+
+            default:
+                // find_escape() 只会停在控制字符上
+                return token_t::parse_error;
+            }
+        }
+    }
+
+    // 校验 '\\' 之后的转义序列 (m_cur 是 '\\' 的下一个字符)
+    // Decode: 解码后追加到 m_buffer
+    template <bool Decode>
+    bool scan_escape() {
+        auto push = [&](char_t ch) {
+            if constexpr (Decode)
+                m_buffer.push_back(ch);
+        };
+        switch (m_cur) {
+        case '\"':
+        case '\\':
+            push(m_cur);
+            return true;
+        case 'b':
+            push('\b');
+            return true;
+        case 'f':
+            push('\f');
+            return true;
+        case 'n':
+            push('\n');
+            return true;
+        case 'r':
+            push('\r');
+            return true;
+        case 't':
+            push('\t');
+            return true;
+        case 'u': {
+            // 解析 4 位的 16 进制数
+            auto parse_hex4 = [&](unsigned& u) {
+                u = 0;
+                for (int i = 0; i < 4; i++) {
+                    next_char();
+                    int digit = hex_digit(m_cur);
+                    if (digit < 0)
+                        return false;
+                    u = (u << 4) | unsigned(digit);
+                }
+                return true;
+            };
+
+            unsigned u, u2;
+            if (!parse_hex4(u))
+                return false;
+            // surrogate pair
+            if (u >= 0xD800 && u <= 0xDBFF) {
+                // '\\' + 'u' + 4 字符
+                next_char();
+                if (m_cur != '\\')
+                    return false;
+                next_char();
+                if (m_cur != 'u')
+                    return false;
+
+                if (!parse_hex4(u2) || (u2 < 0xDC00 || u2 > 0xDFFF))
+                    return false;
+
+                u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
+            }
+            if constexpr (Decode) {
+                char_t utf8[4];
+                m_buffer.append(utf8, to_utf8(u, utf8));
+            }
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    // 16 进制数字的值, 不是 16 进制数字时返回 -1
+    static int hex_digit(char_t ch) {
+        if (ch >= '0' && ch <= '9')
+            return ch - '0';
+        if (ch >= 'A' && ch <= 'F')
+            return ch - ('A' - 10);
+        if (ch >= 'a' && ch <= 'f')
+            return ch - ('a' - 10);
+        return -1;
+    }
+
+    // 已校验过的 4 位 16 进制数
+    static unsigned hex4(const char_t* p) {
+        return unsigned(hex_digit(p[0]) << 12 | hex_digit(p[1]) << 8 |
+                        hex_digit(p[2]) << 4 | hex_digit(p[3]));
+    }
+
+    // 把码点 u 编码为 utf-8 写入 out, 返回写入的末尾
+    static char_t* to_utf8(unsigned u, char_t* out) {
+        // 为什么要做 x & 0xFF 这种操作呢？
+        // 这是因为 u 是 unsigned
+        // 类型，一些编译器可能会警告这个转型可能会截断数据。
+        // 但实际上，配合了范围的检测然后右移之后，可以保证写入的是
+        // 0~255 内的值。 为了避免一些编译器的警告误判，我们加上 x &
+        // 0xFF。
+        // 一般来说，编译器在优化之后，这与操作是会被消去的，不会影响性能。
+        if (u <= 0x7F) {
+            *out++ = char_t(u & 0xFF);
+        } else if (u <= 0x7FF) {
+            *out++ = char_t(0xC0 | ((u >> 6) & 0xFF));
+            *out++ = char_t(0x80 | (u & 0x3F));
+        } else if (u <= 0xFFFF) {
+            *out++ = char_t(0xE0 | ((u >> 12) & 0xFF));
+            *out++ = char_t(0x80 | ((u >> 6) & 0x3F));
+            *out++ = char_t(0x80 | (u & 0x3F));
+        } else {
+            json_assert(u <= 0x10FFFF);
+            *out++ = char_t(0xF0 | ((u >> 18) & 0xFF));
+            *out++ = char_t(0x80 | ((u >> 12) & 0x3F));
+            *out++ = char_t(0x80 | ((u >> 6) & 0x3F));
+            *out++ = char_t(0x80 | (u & 0x3F));
+        }
+        return out;
+    }
+
+    // 一边校验格式，一边累加有效数字 (最多 19 位) 和十进制指数，
+    // 再由 number_parser 转换为 double。
+    // 没有小数和指数部分的整数直接保存为 int64 / uint64, 不经过 double。
+    // 不构造临时字符串，也不依赖 C locale (strtod 依赖)。
     token_t scan_number() {
         // 判断字符串是否为符合 json 格式的 number
         // 详见 docs/ECMA-404_2nd_edition_december_2017.pdf 第四页
+        if (m_raw_numbers)
+            return scan_number_text();
 
         // 判断字符是否为 1-9 的数字
         auto isDigital = [](char c) { return c >= '0' && c <= '9'; };
-        auto it_old = m_it_cur - 1;
 
-        if (m_cur == '-')
+        // 数字的原文，仅在有效数字超过 19 位时才会用到
+        // 连续的输入直接记录指针，否则保存到 m_buffer
+        const char_t* first = nullptr;
+        std::size_t length = 0;
+        if constexpr (is_contiguous)
+            first = m_input.position() - 1;
+        else
+            m_buffer.clear();
+        auto next = [&]() {
+            if constexpr (is_contiguous)
+                length++;
+            else
+                m_buffer.push_back(m_cur);
             next_char();
+        };
+
+        number_parser::decimal_t d;
+        int digits = 0; // 已保存的有效数字个数
+        auto add_digit = [&]() {
+            if (digits < number_parser::max_digits) {
+                d.mantissa = d.mantissa * 10 + std::uint64_t(m_cur - '0');
+                digits++;
+                return true;
+            }
+            // 超过 19 位的数字被舍弃
+            if (m_cur != '0')
+                d.truncated = true;
+            return false;
+        };
+        // 连续的输入一次累加 8 位数字 (SWAR), 见 number_parser
+        auto add_eight_digits = [&]() {
+            if constexpr (is_contiguous) {
+                const char_t* p = m_input.position() - 1; // m_cur
+                if (digits + 8 <= number_parser::max_digits &&
+                    m_input.end() - p >= 8 &&
+                    number_parser::is_eight_digits(p)) {
+                    d.mantissa = d.mantissa * 100000000 +
+                                 number_parser::parse_eight_digits(p);
+                    digits += 8;
+                    length += 8;
+                    m_input.skip_to(p + 8);
+                    next_char();
+                    return true;
+                }
+            }
+            return false;
+        };
+        bool integral = true; // 没有小数和指数部分
+
+        if (m_cur == '-') {
+            d.negative = true;
+            next();
+        }
 
         if (isDigital(m_cur)) {
             if (m_cur != '0') {
-                next_char();
-                while (isDigital(m_cur))
-                    next_char();
+                // 8 位一组, 剩下的逐位累加
+                while (add_eight_digits()) {
+                }
+                while (isDigital(m_cur)) {
+                    if (!add_digit())
+                        d.exponent++;
+                    next();
+                }
             } else
-                next_char();
+                next();
         } else
             return token_t::parse_error;
 
         if (m_cur == '.') {
-            next_char();
+            integral = false;
+            next();
             // 至少要有一个数字
             // 移动指针到下一个非数字的字符
             if (!isDigital(m_cur))
                 return token_t::parse_error;
-            do {
-                next_char();
-            } while (isDigital(m_cur));
+            // 小数部分的前导 0 不是有效数字
+            if (digits == 0) {
+                while (m_cur == '0') {
+                    d.exponent--;
+                    next();
+                }
+            }
+            while (add_eight_digits())
+                d.exponent -= 8;
+            while (isDigital(m_cur)) {
+                if (add_digit())
+                    d.exponent--;
+                next();
+            }
         }
 
         if (m_cur == 'e' || m_cur == 'E') {
-            next_char();
-            if (m_cur == '+' || m_cur == '-')
-                next_char();
+            integral = false;
+            next();
+            bool negative = false;
+            if (m_cur == '+' || m_cur == '-') {
+                negative = m_cur == '-';
+                next();
+            }
             // 至少要有一个数字
             // 移动指针到下一个非数字的字符
             if (!isDigital(m_cur))
                 return token_t::parse_error;
+            std::int64_t exponent = 0;
             do {
-                next_char();
+                // 足够大的指数一定会上溢或下溢，避免 exponent 溢出
+                if (exponent < 0x10000000)
+                    exponent = exponent * 10 + (m_cur - '0');
+                next();
             } while (isDigital(m_cur));
+            d.exponent += negative ? -exponent : exponent;
         }
 
         // 数字格式校验正确
-        // strtod
-        errno = 0;
-        m_value_number = strtod(string_t(it_old, m_it_cur).c_str(), nullptr);
+        const char_t* last;
+        if constexpr (is_contiguous) {
+            last = first + length;
+        } else {
+            first = m_buffer.data();
+            last = first + m_buffer.size();
+        }
+
+        // 整数: 精确保存, -0 仍是 double 以保留符号
+        if (integral && !(d.negative && d.mantissa == 0) &&
+            scan_integer(d, last))
+            return token_t::value_number;
+
+        double value;
         // 数字过大
-        if (errno == ERANGE &&
-            (m_value_number == HUGE_VAL || m_value_number == -HUGE_VAL)) {
+        if (!number_parser::to_double(d, first, last, value))
+            return token_t::parse_error;
+
+        m_number_type = value_t::number;
+        m_value_number = number_t(value);
+        return token_t::value_number;
+    }
+
+    // 只校验格式并记录数字的原文，不累加有效数字，也不转换 (raw_numbers())
+    token_t scan_number_text() {
+        auto isDigital = [](char c) { return c >= '0' && c <= '9'; };
+
+        const char_t* first = nullptr;
+        std::size_t length = 0;
+        if constexpr (is_contiguous)
+            first = m_input.position() - 1;
+        else
+            m_buffer.clear();
+        auto next = [&]() {
+            if constexpr (is_contiguous)
+                length++;
+            else
+                m_buffer.push_back(m_cur);
+            next_char();
+        };
+        // 至少一个数字
+        auto digits = [&]() {
+            if (!isDigital(m_cur))
+                return false;
+            do {
+                next();
+            } while (isDigital(m_cur));
+            return true;
+        };
+
+        if (m_cur == '-')
+            next();
+        if (m_cur == '0')
+            next();
+        else if (!digits())
             return token_t::parse_error;
+
+        if (m_cur == '.') {
+            next();
+            if (!digits())
+                return token_t::parse_error;
+        }
+
+        if (m_cur == 'e' || m_cur == 'E') {
+            next();
+            if (m_cur == '+' || m_cur == '-')
+                next();
+            if (!digits())
+                return token_t::parse_error;
         }
 
+        if constexpr (is_contiguous)
+            m_number_text = std::string_view(first, length);
+        else
+            m_number_text = std::string_view(m_buffer.data(), m_buffer.size());
         return token_t::value_number;
     }
 
+    // 保存整数 d (last 是其原文的末尾), 超出 uint64 / int64 时返回 false
+    bool scan_integer(const number_parser::decimal_t& d, const char_t* last) {
+        std::uint64_t magnitude = d.mantissa;
+        if (d.exponent == 1) {
+            // 20 位的整数, 被舍弃的第 20 位就是最后一个字符
+            auto digit = std::uint64_t(last[-1] - '0');
+            if (magnitude > (UINT64_MAX - digit) / 10)
+                return false;
+            magnitude = magnitude * 10 + digit;
+        } else if (d.exponent != 0) {
+            return false;
+        }
+
+        if (!d.negative) {
+            if (magnitude <= std::uint64_t(INT64_MAX)) {
+                m_number_type = value_t::number_integer;
+                m_value_integer = number_integer_t(magnitude);
+            } else {
+                m_number_type = value_t::number_unsigned;
+                m_value_unsigned = number_unsigned_t(magnitude);
+            }
+            return true;
+        }
+        // |INT64_MIN| = INT64_MAX + 1
+        if (magnitude > std::uint64_t(INT64_MAX) + 1)
+            return false;
+        m_number_type = value_t::number_integer;
+        m_value_integer = magnitude == std::uint64_t(INT64_MAX) + 1
+                              ? INT64_MIN
+                              : -number_integer_t(magnitude);
+        return true;
+    }
+
 private:
     // next character
-    inline void next_char() {
-        m_cur = (m_it_cur == m_it_end) ? '\0' : *m_it_cur++;
-    }
+    inline void next_char() { m_cur = m_input.get_character(); }
 
     // skip all whitespaces
     inline void skip_whitespace() {
@@ -0,0 +1,341 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+#include "simd.hpp"        // simd, JSON_HAS_SIMD_X86, JSON_TARGET_AVX2
+
+#include <algorithm> // min
+#include <cstddef>   // size_t, ptrdiff_t
+#include <cstring>   // memcpy
+#include <iterator>  // random_access_iterator_tag
+#include <limits>    // numeric_limits
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief read-only view of the numbers of an array, without copying them
+ * @details The numbers are doubles stored `stride` bytes apart, in the
+ * nodes of a basic_json array (see basic_json::numbers()). With the
+ * compact layout a number node is the double itself, the view is then a
+ * plain contiguous buffer; the other layouts keep the double inside a
+ * wider node.
+ * An array holding integers is viewed through a load function that
+ * converts each element to a double (exact up to 2^53): the reductions
+ * convert a block of elements at a time into a buffer and run the same
+ * kernels on it.
+ * sum(), min(), max() and mean() are vectorized (AVX2 or SSE2, selected
+ * at runtime like simd::find_escape()). sum() adds in several lanes, the
+ * result may differ from a sequential sum in the last bits. With a NaN in
+ * the view the result of min() and max() is unspecified.
+ * The view is invalidated by any change of the array.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class number_span {
+public:
+    // reduces n numbers starting at first, stride bytes apart
+    using reduce_function = double (*)(const unsigned char* first,
+                                       std::size_t n, std::size_t stride);
+    // the element at p as a double, for elements that are not doubles
+    using load_function = double (*)(const unsigned char* p);
+
+    // the kernels of one simd level
+    struct reduce_functions {
+        reduce_function sum;
+        reduce_function min;
+        reduce_function max;
+    };
+
+    class const_iterator {
+    private:
+        const unsigned char* m_p = nullptr;
+        std::size_t m_stride = 0;
+        load_function m_load = nullptr;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = double;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = double;
+
+        const_iterator() = default;
+        const_iterator(const unsigned char* p, std::size_t stride,
+                       load_function f = nullptr)
+            : m_p(p), m_stride(stride), m_load(f) {}
+
+        double operator*() const { return load(m_p, m_load); }
+        double operator[](difference_type n) const {
+            return load(m_p + n * difference_type(m_stride), m_load);
+        }
+
+        const_iterator& operator++() {
+            m_p += m_stride;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto ret = *this;
+            m_p += m_stride;
+            return ret;
+        }
+        const_iterator& operator--() {
+            m_p -= m_stride;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto ret = *this;
+            m_p -= m_stride;
+            return ret;
+        }
+        const_iterator& operator+=(difference_type n) {
+            m_p += n * difference_type(m_stride);
+            return *this;
+        }
+        const_iterator& operator-=(difference_type n) { return *this += -n; }
+        friend const_iterator operator+(const_iterator it, difference_type n) {
+            return it += n;
+        }
+        friend const_iterator operator-(const_iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const const_iterator& lhs,
+                                         const const_iterator& rhs) {
+            return (lhs.m_p - rhs.m_p) / difference_type(lhs.m_stride);
+        }
+
+        friend bool operator==(const const_iterator& lhs,
+                               const const_iterator& rhs) {
+            return lhs.m_p == rhs.m_p;
+        }
+        friend bool operator!=(const const_iterator& lhs,
+                               const const_iterator& rhs) {
+            return lhs.m_p != rhs.m_p;
+        }
+        friend bool operator<(const const_iterator& lhs,
+                              const const_iterator& rhs) {
+            return lhs.m_p < rhs.m_p;
+        }
+    };
+
+    using iterator = const_iterator;
+
+private:
+    // elements converted per reduction step
+    static constexpr std::size_t block_size = 256;
+
+    const unsigned char* m_first = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_stride = sizeof(double);
+    load_function m_load = nullptr; // nullptr: the elements are doubles
+
+public:
+    number_span() = default;
+    number_span(const unsigned char* first, std::size_t size,
+                std::size_t stride, load_function f = nullptr)
+        : m_first(first), m_size(size), m_stride(stride), m_load(f) {
+        json_assert(stride >= sizeof(double));
+    }
+
+    std::size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    // the first number, for the kernels of functions() unless converting()
+    const unsigned char* bytes() const noexcept { return m_first; }
+    // bytes from one number to the next
+    std::size_t stride() const noexcept { return m_stride; }
+    // the elements are converted to doubles when read (integers)
+    bool converting() const noexcept { return m_load != nullptr; }
+    // the numbers are a plain double buffer
+    bool contiguous() const noexcept {
+        return !converting() && m_stride == sizeof(double);
+    }
+
+    double operator[](std::size_t i) const {
+        json_assert(i < m_size);
+        return load(m_first + i * m_stride, m_load);
+    }
+    double front() const { return (*this)[0]; }
+    double back() const { return (*this)[m_size - 1]; }
+
+    const_iterator begin() const noexcept {
+        return {m_first, m_stride, m_load};
+    }
+    const_iterator end() const noexcept {
+        return {m_first + m_size * m_stride, m_stride, m_load};
+    }
+
+    double sum() const { return reduce<add_op>(functions().sum); }
+
+    // the span must not be empty
+    double min() const {
+        json_assert(!empty());
+        return reduce<min_op>(functions().min);
+    }
+    double max() const {
+        json_assert(!empty());
+        return reduce<max_op>(functions().max);
+    }
+    double mean() const {
+        json_assert(!empty());
+        return sum() / double(m_size);
+    }
+
+    // the kernels of a level, scalar ones if it is not compiled in
+    static reduce_functions functions(simd::level l) {
+        switch (l) {
+#if defined(JSON_HAS_SIMD_X86)
+        case simd::level::avx2:
+            return {reduce_avx2<add_op>, reduce_avx2<min_op>,
+                    reduce_avx2<max_op>};
+        case simd::level::sse2:
+            return {reduce_sse2<add_op>, reduce_sse2<min_op>,
+                    reduce_sse2<max_op>};
+#endif
+        default:
+            return {reduce_scalar<add_op>, reduce_scalar<min_op>,
+                    reduce_scalar<max_op>};
+        }
+    }
+
+private:
+    // memcpy: the bytes may belong to a node that is not a double object
+    static double load(const unsigned char* p) {
+        double ret;
+        std::memcpy(&ret, p, sizeof(ret));
+        return ret;
+    }
+    static double load(const unsigned char* p, load_function f) {
+        return f == nullptr ? load(p) : f(p);
+    }
+
+    // the kernel f over the span, converted elements go through a buffer
+    template <typename Op>
+    double reduce(reduce_function f) const {
+        if (m_load == nullptr)
+            return f(m_first, m_size, m_stride);
+        double buffer[block_size];
+        double ret = Op::identity;
+        const unsigned char* p = m_first;
+        for (std::size_t i = 0; i < m_size; i += block_size) {
+            const std::size_t n = std::min(block_size, m_size - i);
+            for (std::size_t k = 0; k < n; k++, p += m_stride)
+                buffer[k] = m_load(p);
+            ret = Op::scalar(
+                ret, f(reinterpret_cast<const unsigned char*>(buffer), n,
+                       sizeof(double)));
+        }
+        return ret;
+    }
+
+    static const reduce_functions& functions() {
+        static const reduce_functions f = functions(simd::detect());
+        return f;
+    }
+
+    // an operation: its identity and its scalar / vector forms
+    struct add_op {
+        static constexpr double identity = 0.0;
+        static double scalar(double a, double b) { return a + b; }
+#if defined(JSON_HAS_SIMD_X86)
+        static __m128d sse2(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+        JSON_TARGET_AVX2
+        static __m256d avx2(__m256d a, __m256d b) {
+            return _mm256_add_pd(a, b);
+        }
+#endif
+    };
+
+    struct min_op {
+        static constexpr double identity =
+            std::numeric_limits<double>::infinity();
+        static double scalar(double a, double b) { return b < a ? b : a; }
+#if defined(JSON_HAS_SIMD_X86)
+        static __m128d sse2(__m128d a, __m128d b) { return _mm_min_pd(a, b); }
+        JSON_TARGET_AVX2
+        static __m256d avx2(__m256d a, __m256d b) {
+            return _mm256_min_pd(a, b);
+        }
+#endif
+    };
+
+    struct max_op {
+        static constexpr double identity =
+            -std::numeric_limits<double>::infinity();
+        static double scalar(double a, double b) { return b > a ? b : a; }
+#if defined(JSON_HAS_SIMD_X86)
+        static __m128d sse2(__m128d a, __m128d b) { return _mm_max_pd(a, b); }
+        JSON_TARGET_AVX2
+        static __m256d avx2(__m256d a, __m256d b) {
+            return _mm256_max_pd(a, b);
+        }
+#endif
+    };
+
+    template <typename Op>
+    static double reduce_scalar(const unsigned char* first, std::size_t n,
+                                std::size_t stride) {
+        double ret = Op::identity;
+        for (std::size_t i = 0; i < n; i++, first += stride)
+            ret = Op::scalar(ret, load(first));
+        return ret;
+    }
+
+#if defined(JSON_HAS_SIMD_X86)
+    // two numbers, contiguous or one 64 bit load each
+    static __m128d load2(const unsigned char* p, std::size_t stride) {
+        if (stride == sizeof(double))
+            return _mm_loadu_pd(reinterpret_cast<const double*>(p));
+        return _mm_loadh_pd(_mm_set_sd(load(p)),
+                            reinterpret_cast<const double*>(p + stride));
+    }
+
+    template <typename Op>
+    static double reduce_sse2(const unsigned char* first, std::size_t n,
+                              std::size_t stride) {
+        // two accumulators hide the latency of the operation
+        __m128d a = _mm_set1_pd(Op::identity);
+        __m128d b = a;
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4, first += 4 * stride) {
+            a = Op::sse2(a, load2(first, stride));
+            b = Op::sse2(b, load2(first + 2 * stride, stride));
+        }
+        a = Op::sse2(a, b);
+        double lanes[2];
+        _mm_storeu_pd(lanes, a);
+        double ret = Op::scalar(lanes[0], lanes[1]);
+        return Op::scalar(ret, reduce_scalar<Op>(first, n - i, stride));
+    }
+
+    template <typename Op>
+    JSON_TARGET_AVX2 static double
+    reduce_avx2(const unsigned char* first, std::size_t n,
+                std::size_t stride) {
+        // the strided layouts gain nothing over SSE2 loads
+        if (stride != sizeof(double))
+            return reduce_sse2<Op>(first, n, stride);
+
+        auto d = reinterpret_cast<const double*>(first);
+        __m256d acc[4];
+        for (auto& i : acc)
+            i = _mm256_set1_pd(Op::identity);
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            acc[0] = Op::avx2(acc[0], _mm256_loadu_pd(d + i));
+            acc[1] = Op::avx2(acc[1], _mm256_loadu_pd(d + i + 4));
+            acc[2] = Op::avx2(acc[2], _mm256_loadu_pd(d + i + 8));
+            acc[3] = Op::avx2(acc[3], _mm256_loadu_pd(d + i + 12));
+        }
+        for (; i + 4 <= n; i += 4)
+            acc[0] = Op::avx2(acc[0], _mm256_loadu_pd(d + i));
+        __m256d v = Op::avx2(Op::avx2(acc[0], acc[1]),
+                             Op::avx2(acc[2], acc[3]));
+        double lanes[4];
+        _mm256_storeu_pd(lanes, v);
+        double ret = Op::scalar(Op::scalar(lanes[0], lanes[1]),
+                                Op::scalar(lanes[2], lanes[3]));
+        return Op::scalar(ret, reduce_scalar<Op>(first + i * sizeof(double),
+                                                 n - i, stride));
+    }
+#endif
+};
+} // namespace detail
+} // namespace microlife
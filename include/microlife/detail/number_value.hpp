@@ -0,0 +1,131 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+#include "value_t.hpp"
+
+#include <cstdint>     // int64_t, uint64_t
+#include <limits>      // numeric_limits
+#include <type_traits> // is_integral, is_signed, make_unsigned
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief a number of any kind, read from a node
+ * @details type is value_t::number (a FloatType), number_integer or
+ * number_unsigned. fits<T>() tells whether the value is in the range of
+ * an arithmetic type T, to<T>() converts it (a float is truncated towards
+ * zero, like static_cast). Shared by basic_json and basic_document, so
+ * that both convert and compare the three kinds in the same way.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename FloatType, typename IntegerType = std::int64_t,
+          typename UnsignedType = std::uint64_t>
+struct number_value {
+    value_t type = value_t::number;
+    union {
+        FloatType number;
+        IntegerType integer;
+        UnsignedType unsigned_integer;
+    };
+
+    number_value() : number(0) {}
+    static number_value from_float(FloatType v) {
+        number_value ret;
+        ret.number = v;
+        return ret;
+    }
+    static number_value from_integer(IntegerType v) {
+        number_value ret;
+        ret.type = value_t::number_integer;
+        ret.integer = v;
+        return ret;
+    }
+    static number_value from_unsigned(UnsignedType v) {
+        number_value ret;
+        ret.type = value_t::number_unsigned;
+        ret.unsigned_integer = v;
+        return ret;
+    }
+
+    // the value is in the range of T
+    template <typename T>
+    bool fits() const {
+        switch (type) {
+        case value_t::number_integer:
+            return in_range<T>(integer);
+        case value_t::number_unsigned:
+            return in_range<T>(unsigned_integer);
+        default:
+            return in_range<T>(number);
+        }
+    }
+
+    template <typename T>
+    T to() const {
+        switch (type) {
+        case value_t::number_integer:
+            return static_cast<T>(integer);
+        case value_t::number_unsigned:
+            return static_cast<T>(unsigned_integer);
+        default:
+            return static_cast<T>(number);
+        }
+    }
+
+    /***
+     * @brief compare two numbers by value, whatever their kinds
+     * @details Returns 0, -1 or 1. Two integers are compared exactly, an
+     * integer and a float are compared as FloatType.
+     */
+    static int compare(const number_value& left, const number_value& right) {
+        if (left.type == value_t::number || right.type == value_t::number)
+            return sign(left.to<FloatType>(), right.to<FloatType>());
+        if (left.type == right.type) {
+            return left.type == value_t::number_integer
+                       ? sign(left.integer, right.integer)
+                       : sign(left.unsigned_integer, right.unsigned_integer);
+        }
+        // an integer and an unsigned
+        if (left.type == value_t::number_integer) {
+            return left.integer < 0
+                       ? -1
+                       : sign(UnsignedType(left.integer),
+                              right.unsigned_integer);
+        }
+        return right.integer < 0
+                   ? 1
+                   : sign(left.unsigned_integer,
+                          UnsignedType(right.integer));
+    }
+
+private:
+    template <typename T>
+    static int sign(T a, T b) {
+        return a == b ? 0 : (a > b ? 1 : -1);
+    }
+
+    // an integer v in the range of T
+    template <typename T, typename U>
+    static bool in_range(U v) {
+        using limits = std::numeric_limits<T>;
+        if constexpr (!std::is_integral_v<T>) {
+            return true;
+        } else if constexpr (std::is_floating_point_v<U>) {
+            // 2^digits, exact in every float type
+            const U limit =
+                U(2) * U(std::uint64_t(1) << (limits::digits - 1));
+            if constexpr (std::is_signed_v<T>)
+                return v >= -limit && v < limit;
+            else
+                return v > U(-1) && v < limit;
+        } else if constexpr (std::is_signed_v<U> == std::is_signed_v<T>) {
+            return v >= limits::lowest() && v <= limits::max();
+        } else if constexpr (std::is_signed_v<U>) {
+            return v >= 0 && std::make_unsigned_t<U>(v) <= limits::max();
+        } else {
+            return v <= std::make_unsigned_t<T>(limits::max());
+        }
+    }
+};
+} // namespace detail
+} // namespace microlife
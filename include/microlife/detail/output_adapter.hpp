@@ -0,0 +1,227 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+
+#include <algorithm> // min
+#include <cstddef>   // size_t
+#include <cstdio>    // FILE, fwrite
+#include <cstring>   // memcpy
+#include <ostream>   // ostream
+#include <string>    // string
+#include <utility>   // declval
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>   // errno, EINTR
+#include <unistd.h> // write
+#define JSON_HAS_FD_OUTPUT 1
+#endif
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief output adapter appending to a string
+ * @details Every output adapter provides write_character() and
+ * write_characters(), the serializer writes to it in one pass.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename StringType = std::string>
+class string_output_adapter {
+public:
+    using char_t = char;
+
+private:
+    StringType& m_str;
+
+public:
+    explicit string_output_adapter(StringType& str) : m_str(str) {}
+
+    void write_character(char_t c) { m_str.push_back(c); }
+
+    void write_characters(const char_t* s, std::size_t length) {
+        m_str.append(s, length);
+    }
+};
+
+/***
+ * @brief output adapter writing to a std::ostream
+ * @details The stream buffers by itself.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class stream_output_adapter {
+public:
+    using char_t = char;
+
+private:
+    std::ostream& m_stream;
+
+public:
+    explicit stream_output_adapter(std::ostream& s) : m_stream(s) {}
+
+    void write_character(char_t c) { m_stream.put(c); }
+
+    void write_characters(const char_t* s, std::size_t length) {
+        m_stream.write(s, static_cast<std::streamsize>(length));
+    }
+};
+
+/***
+ * @brief output adapter writing to a C FILE*
+ * @details stdio buffers by itself, the file is neither flushed nor closed.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class file_output_adapter {
+public:
+    using char_t = char;
+
+private:
+    std::FILE* m_file;
+
+public:
+    explicit file_output_adapter(std::FILE* f) : m_file(f) {
+        json_assert(f != nullptr);
+    }
+
+    void write_character(char_t c) { std::fputc(c, m_file); }
+
+    void write_characters(const char_t* s, std::size_t length) {
+        std::fwrite(s, 1, length, m_file);
+    }
+};
+
+#if defined(JSON_HAS_FD_OUTPUT)
+/***
+ * @brief output adapter writing to a file descriptor (POSIX)
+ * @details Collects the output in a small buffer and calls write(2) when it
+ * is full and when the adapter is destroyed. good() is false once a write
+ * failed, the rest of the output is dropped.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class fd_output_adapter {
+public:
+    using char_t = char;
+
+    static constexpr std::size_t buffer_size = 4096;
+
+private:
+    int m_fd;
+    bool m_good = true;
+    std::size_t m_size = 0;
+    char_t m_buffer[buffer_size];
+
+public:
+    explicit fd_output_adapter(int fd) : m_fd(fd) { json_assert(fd >= 0); }
+    fd_output_adapter(const fd_output_adapter&) = delete;
+    fd_output_adapter& operator=(const fd_output_adapter&) = delete;
+    ~fd_output_adapter() { flush(); }
+
+    void write_character(char_t c) {
+        if (m_size == buffer_size)
+            flush();
+        m_buffer[m_size++] = c;
+    }
+
+    void write_characters(const char_t* s, std::size_t length) {
+        if (m_size + length > buffer_size) {
+            flush();
+            // large blocks bypass the buffer
+            if (length >= buffer_size) {
+                write_all(s, length);
+                return;
+            }
+        }
+        std::memcpy(m_buffer + m_size, s, length);
+        m_size += length;
+    }
+
+    // write the buffered characters
+    void flush() {
+        write_all(m_buffer, m_size);
+        m_size = 0;
+    }
+
+    bool good() const { return m_good; }
+
+private:
+    void write_all(const char_t* s, std::size_t length) {
+        while (m_good && length > 0) {
+            auto n = ::write(m_fd, s, length);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                m_good = false;
+                return;
+            }
+            s += n;
+            length -= std::size_t(n);
+        }
+    }
+};
+#endif
+
+/***
+ * @brief output adapter writing to a fixed buffer
+ * @details Like snprintf: at most `size` characters are stored, no null
+ * byte is added. size() reports the length of the whole output, so a
+ * result larger than the buffer tells how much space is needed.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class buffer_output_adapter {
+public:
+    using char_t = char;
+
+private:
+    char_t* m_first;
+    std::size_t m_capacity;
+    std::size_t m_size = 0; // including the characters that did not fit
+
+public:
+    buffer_output_adapter(char_t* first, std::size_t capacity)
+        : m_first(first), m_capacity(capacity) {
+        json_assert(first != nullptr || capacity == 0);
+    }
+
+    void write_character(char_t c) {
+        if (m_size < m_capacity)
+            m_first[m_size] = c;
+        m_size++;
+    }
+
+    void write_characters(const char_t* s, std::size_t length) {
+        if (m_size < m_capacity)
+            std::memcpy(m_first + m_size, s,
+                        std::min(length, m_capacity - m_size));
+        m_size += length;
+    }
+
+    // length of the whole output
+    std::size_t size() const { return m_size; }
+
+    // whether the output was cut
+    bool truncated() const { return m_size > m_capacity; }
+};
+
+// std::string and other strings with push_back() / append()
+template <typename StringType,
+          typename = decltype(std::declval<StringType&>().append(
+              std::declval<const char*>(), std::size_t(0)))>
+string_output_adapter<StringType> output_adapter(StringType& str) {
+    return string_output_adapter<StringType>(str);
+}
+
+inline stream_output_adapter output_adapter(std::ostream& s) {
+    return stream_output_adapter(s);
+}
+
+inline file_output_adapter output_adapter(std::FILE* f) {
+    return file_output_adapter(f);
+}
+
+inline buffer_output_adapter output_adapter(char* first, std::size_t size) {
+    return buffer_output_adapter(first, size);
+}
+} // namespace detail
+} // namespace microlife
@@ -1,18 +1,27 @@
 #pragma once
-#include "macro_scope.hpp" // json_assert()
+#include "input_adapter.hpp" // input_adapter()
+#include "json_sax.hpp"      // json_sax_dom_parser, has_number_*
+#include "macro_scope.hpp"   // json_assert()
 
-#include <memory> // std::unique_ptr
-#include <stack>  // stack
+#include <type_traits> // decay_t
+#include <vector>      // vector
 
 namespace microlife {
 namespace detail {
 /***
  * @brief JSON parser
- * @details Parses JSON string and returns a tree of nodes
+ * @details Checks the JSON grammar and reports every value to a SAX handler
+ * (see json_sax.hpp). parse() uses json_sax_dom_parser to build a tree of
+ * nodes, sax_parse() accepts any other handler. The parser itself only keeps
+ * one byte per open array/object, so a handler that does not store the
+ * values runs in constant memory.
+ * The input may be anything accepted by input_adapter(): contiguous inputs
+ * reuse the lexer (and its buffer) of the parser, other iterator ranges
+ * get a lexer of their own.
  * @author qingl
  * @date 2022_04_09
  */
-template <template <typename> class LexerType, typename JsonType>
+template <template <typename...> class LexerType, typename JsonType>
 class parser {
 private:
     using basic_json = JsonType;
@@ -25,236 +34,227 @@ private:
 
     using lexer = LexerType<basic_json>;
     using token_t = ::microlife::detail::token_t;
-
-    using stack_token_t = std::stack<std::pair<token_t, basic_json*>>;
+    using dom_parser = ::microlife::detail::json_sax_dom_parser<basic_json>;
 
 private:
-    lexer m_lexer;                       // lexer
-    std::stack<token_t> m_stack_token;   // stack for tokens
-    std::stack<basic_json> m_stack_json; // stack for json values
+    lexer m_lexer;                  // lexer
+    std::vector<value_t> m_states;  // open arrays/objects, innermost last
+    dom_parser m_dom;               // handler used by parse()
 
 public:
     parser() {}
     ~parser() {}
 
-    bool parse(const string_t& str, basic_json& json) {
-        m_lexer.init(str.begin(), str.end());
-
-        json_assert(m_stack_token.empty());
-        json_assert(m_stack_json.empty());
-
-        auto parse_json = basic_parse();
-        // clean stacks
-        while (!m_stack_token.empty())
-            m_stack_token.pop();
-
-        while (!m_stack_json.empty())
-            m_stack_json.pop();
+    // parse input into json, json is untouched on failure
+    // the tree is built with the allocator of json
+    template <typename InputType>
+    bool parse(InputType&& input, basic_json& json) {
+        basic_json result(json.get_allocator());
+        m_dom.reset(result);
+
+        auto ret = sax_parse(std::forward<InputType>(input), &m_dom);
+        if (ret)
+            json = std::move(result);
+        return ret;
+    }
 
-        if (parse_json != nullptr) {
-            json = std::move(*parse_json);
-            delete parse_json;
-            parse_json = nullptr;
-            return true;
-        } else
-            return false;
+    // parse input and report the values to sax
+    template <typename InputType, typename SAX>
+    bool sax_parse(InputType&& input, SAX* sax) {
+        json_assert(sax != nullptr);
+        // on entry: a handler that threw left the states of its parse
+        m_states.clear();
+        auto adapter =
+            ::microlife::detail::input_adapter(std::forward<InputType>(input));
+        using adapter_t = decltype(adapter);
+
+        bool ret;
+        if constexpr (std::is_same_v<adapter_t, typename lexer::input_t>) {
+            m_lexer.init(std::move(adapter));
+            m_lexer.raw_numbers(wants_number_text(sax));
+            m_lexer.raw_strings(wants_string_text(sax));
+            ret = sax_parse_internal(m_lexer, sax);
+        } else {
+            // strings are copied, the input cannot be viewed
+            LexerType<basic_json, adapter_t> lex(std::move(adapter));
+            lex.raw_numbers(wants_number_text(sax));
+            ret = sax_parse_internal(lex, sax);
+        }
+        return ret;
     }
 
     // private
     JSON_PRIVATE_UNLESS_TESTED
 
-    basic_json* basic_parse() {
-        // literal_null
-        // 所有的值类型都是 literal_null
+    template <typename Lexer, typename SAX>
+    bool sax_parse_internal(Lexer& lex, SAX* sax) {
+        token_t token = lex.scan();
 
         while (true) {
-            token_t token = m_lexer.scan();
-
+            // 1. token is the first token of a value
             switch (token) {
-            case token_t::end_of_input: {
-                if (m_stack_token.size() == 1 &&
-                    m_stack_token.top() == token_t::literal_null &&
-                    m_stack_json.size() == 1) {
-                    return new basic_json(std::move(m_stack_json.top()));
-                }
-                return nullptr;
-            }
-
-            case token_t::end_array: {
-                token = token_t::literal_null;
-
-                auto json_array = parse_end_array();
-                if (json_array == nullptr)
-                    return nullptr;
-                else {
-                    m_stack_json.push(std::move(*json_array));
-                    delete json_array;
+            case token_t::begin_array:
+                if (!sax->start_array())
+                    return false;
+                token = lex.scan();
+                if (token == token_t::end_array) {
+                    if (!sax->end_array())
+                        return false;
+                    break;
                 }
-                break;
-            }
+                // descend into the first element
+                m_states.push_back(value_t::array);
+                continue;
 
-            case token_t::end_object: {
-                token = token_t::literal_null;
-
-                auto json_object = parse_end_object();
-                if (json_object == nullptr)
-                    return nullptr;
-                else {
-                    m_stack_json.push(std::move(*json_object));
-                    delete json_object;
+            case token_t::begin_object:
+                if (!sax->start_object())
+                    return false;
+                token = lex.scan();
+                if (token == token_t::end_object) {
+                    if (!sax->end_object())
+                        return false;
+                    break;
                 }
-                break;
-            }
+                // descend into the first member
+                m_states.push_back(value_t::object);
+                if (!parse_key(lex, sax, token))
+                    return false;
+                continue;
 
             case token_t::literal_null:
-                token = token_t::literal_null;
-                m_stack_json.push(std::move(basic_json(nullptr)));
+                if (!sax->null())
+                    return false;
                 break;
 
             case token_t::literal_true:
-                token = token_t::literal_null;
-                m_stack_json.push(std::move(basic_json(true)));
+                if (!sax->boolean(true))
+                    return false;
                 break;
 
             case token_t::literal_false:
-                token = token_t::literal_null;
-                m_stack_json.push(std::move(basic_json(false)));
+                if (!sax->boolean(false))
+                    return false;
                 break;
 
             case token_t::value_number:
-                token = token_t::literal_null;
-                m_stack_json.push(std::move(basic_json(m_lexer.get_number())));
+                if (!parse_number(lex, sax))
+                    return false;
                 break;
 
             case token_t::value_string:
-                token = token_t::literal_null;
-                m_stack_json.push(std::move(basic_json(m_lexer.get_string())));
-                break;
-
-            case token_t::begin_array:
-            case token_t::begin_object:
-            case token_t::value_separator:
-            case token_t::name_separator:
+                if (!parse_string(lex, sax, false))
+                    return false;
                 break;
 
             case token_t::parse_error:
             default:
-                return nullptr;
+                return false;
             }
 
-            m_stack_token.push(token);
+            // 2. the value is complete, close containers until we find the
+            // next value
+            while (true) {
+                token = lex.scan();
+                if (m_states.empty())
+                    return token == token_t::end_of_input;
+
+                if (m_states.back() == value_t::array) {
+                    if (token == token_t::value_separator) {
+                        token = lex.scan();
+                        break;
+                    } else if (token != token_t::end_array ||
+                               !sax->end_array())
+                        return false;
+                } else {
+                    if (token == token_t::value_separator) {
+                        token = lex.scan();
+                        if (!parse_key(lex, sax, token))
+                            return false;
+                        break;
+                    } else if (token != token_t::end_object ||
+                               !sax->end_object())
+                        return false;
+                }
+                m_states.pop_back();
+            }
         }
     }
 
-// token 为值类型时，插入到 array 末尾
-#define PUSH_VALUE_TO_ARRAY()                                                  \
-    do {                                                                       \
-        m_stack_token.pop();                                                   \
-        if (m_stack_json.empty())                                              \
-            return nullptr;                                                    \
-        array.push_back(std::move(m_stack_json.top()));                        \
-        m_stack_json.pop();                                                    \
-    } while (0)
-
-    basic_json* parse_end_array() {
-        if (m_stack_token.empty())
-            return nullptr;
-
-        // 如果第一个 value
-        // 剩下的一定是 ,' + value
-        // 最后则是 '['
-        array_t array;
-        if (m_stack_token.top() == token_t::literal_null) {
-            PUSH_VALUE_TO_ARRAY();
-
-            while (m_stack_token.size() >= 2) {
-                if (m_stack_token.top() == token_t::begin_array)
-                    break;
+public:
+    // reporting a token to a handler, shared with structural_parser
+
+    // the handler takes numbers as text, see json_sax
+    template <typename SAX>
+    static bool wants_number_text(const SAX* sax) {
+        if constexpr (has_number_text<SAX>::value)
+            return sax->raw_numbers();
+        else
+            return false;
+    }
 
-                // ,' + value
-                if (m_stack_token.top() != token_t::value_separator)
-                    return nullptr;
-                m_stack_token.pop();
-                if (m_stack_token.top() != token_t::literal_null)
-                    return nullptr;
+    // the handler takes strings as text, see json_sax
+    template <typename SAX>
+    static bool wants_string_text(const SAX* sax) {
+        if constexpr (has_string_text<SAX>::value)
+            return sax->raw_strings();
+        else
+            return false;
+    }
 
-                PUSH_VALUE_TO_ARRAY();
+    // report the string just scanned as a value or as a key
+    template <typename Lexer, typename SAX>
+    static bool parse_string(Lexer& lex, SAX* sax, bool is_key) {
+        if constexpr (has_string_text<SAX>::value) {
+            if (lex.raw_strings()) {
+                return is_key ? sax->key_text(lex.get_string_text(),
+                                              lex.string_escaped())
+                              : sax->string_text(lex.get_string_text(),
+                                                 lex.string_escaped());
             }
         }
-
-        // '['
-        if (m_stack_token.empty() ||
-            m_stack_token.top() != token_t::begin_array)
-            return nullptr;
-        m_stack_token.pop();
-        return new basic_json(std::move(array));
+        string_t&& str = lex.get_string();
+        return is_key ? sax->key(str) : sax->string(str);
     }
 
-// token 为值类型时，插入到 object 末尾
-#define PUSH_VALUE_TO_OBJECT()                                                 \
-    do {                                                                       \
-        m_stack_token.pop();                                                   \
-        if (m_stack_token.top() != token_t::name_separator)                    \
-            return nullptr;                                                    \
-        m_stack_token.pop();                                                   \
-        if (m_stack_token.top() != token_t::literal_null)                      \
-            return nullptr;                                                    \
-        m_stack_token.pop();                                                   \
-        /* value */                                                            \
-        if (m_stack_json.empty())                                              \
-            return nullptr;                                                    \
-        auto value = std::move(m_stack_json.top());                            \
-        m_stack_json.pop();                                                    \
-        /* key */                                                              \
-        if (m_stack_json.empty())                                              \
-            return nullptr;                                                    \
-        auto key = std::move(m_stack_json.top());                              \
-        m_stack_json.pop();                                                    \
-        /* key.type == string */                                               \
-        if (!key.is_string())                                                  \
-            return nullptr;                                                    \
-        /* https://stackoverflow.com/questions/7397934/                        \
-        calling-template-function-within-template-class       */               \
-        object.emplace(std::move(key.template get<string_t&>()),               \
-                       std::move(value));                                      \
-    } while (0)
-
-    basic_json* parse_end_object() {
-        if (m_stack_token.empty())
-            return nullptr;
-
-        // 如果第一个 value : key
-        // 剩下的一定是 ,' + value : key
-        // 最后则是 '{'
-        object_t object;
-        if (m_stack_token.size() >= 4 &&
-            m_stack_token.top() == token_t::literal_null) {
-            PUSH_VALUE_TO_OBJECT();
-
-            while (m_stack_token.size() >= 4) {
-                if (m_stack_token.top() == token_t::begin_object)
-                    break;
-
-                // ,' + value : key
-                if (m_stack_token.top() != token_t::value_separator)
-                    return nullptr;
-                m_stack_token.pop();
-                if (m_stack_token.top() != token_t::literal_null)
-                    return nullptr;
-                PUSH_VALUE_TO_OBJECT();
-            }
+    // report the number just scanned, integers go to number_integer() /
+    // number_unsigned() if the handler has them
+    template <typename Lexer, typename SAX>
+    static bool parse_number(Lexer& lex, SAX* sax) {
+        using number_integer_t = typename basic_json::number_integer_t;
+        using number_unsigned_t = typename basic_json::number_unsigned_t;
+        if constexpr (has_number_text<SAX>::value) {
+            if (lex.raw_numbers())
+                return sax->number_text(lex.get_number_text());
         }
-
-        // '{'
-        if (m_stack_token.empty() ||
-            m_stack_token.top() != token_t::begin_object)
-            return nullptr;
-        m_stack_token.pop();
-        return new basic_json(std::move(object));
+        switch (lex.get_number_type()) {
+        case value_t::number_integer:
+            if constexpr (has_number_integer<SAX, number_integer_t>::value)
+                return sax->number_integer(lex.get_number_integer());
+            break;
+        case value_t::number_unsigned:
+            if constexpr (has_number_unsigned<SAX, number_unsigned_t>::value)
+                return sax->number_unsigned(lex.get_number_unsigned());
+            break;
+        default:
+            break;
+        }
+        return sax->number(lex.get_number());
     }
 
-#undef PUSH_VALUE_TO_ARRAY
-#undef PUSH_VALUE_TO_OBJECT
+private:
+    // token is the key of a member: `string ':'`
+    // report the key and scan the first token of the value
+    template <typename Lexer, typename SAX>
+    inline bool parse_key(Lexer& lex, SAX* sax, token_t& token) {
+        if (token != token_t::value_string)
+            return false;
+        if (!parse_string(lex, sax, true))
+            return false;
+        if (lex.scan() != token_t::name_separator)
+            return false;
+        token = lex.scan();
+        return true;
+    }
 };
 } // namespace detail
 } // namespace microlife
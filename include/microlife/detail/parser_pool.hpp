@@ -0,0 +1,83 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+
+#include <memory> // unique_ptr
+#include <vector> // vector
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief per-thread cache of parsers
+ * @details A parser keeps its buffers (string buffer, state stacks) between
+ * two calls, so reusing one avoids growing them again for every document.
+ * Each thread owns its own free list, so no locking is needed. acquire()
+ * takes a parser out of the list for the lifetime of the returned handle,
+ * which keeps parsing reentrant: a nested parse (e.g. from a SAX handler)
+ * simply gets another parser.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename ParserType>
+class parser_pool {
+public:
+    using parser = ParserType;
+
+    // parsers kept per thread, extra ones are freed when released
+    static constexpr std::size_t max_cached = 4;
+
+    /***
+     * @brief a parser borrowed from the pool
+     * @details Returns the parser to the pool of the current thread when
+     * destroyed. Not copyable, do not pass it to another thread.
+     */
+    class handle {
+    private:
+        std::unique_ptr<parser> m_parser;
+
+    public:
+        explicit handle(std::unique_ptr<parser> p) : m_parser(std::move(p)) {}
+        handle(handle&&) noexcept = default;
+        handle(const handle&) = delete;
+        handle& operator=(const handle&) = delete;
+        handle& operator=(handle&&) = delete;
+
+        ~handle() {
+            if (m_parser != nullptr)
+                release(std::move(m_parser));
+        }
+
+        parser& operator*() const { return *m_parser; }
+        parser* operator->() const { return m_parser.get(); }
+    };
+
+public:
+    // borrow a parser of the current thread, create one if none is free
+    static handle acquire() {
+        auto& list = free_list();
+        if (list.empty())
+            return handle(std::make_unique<parser>());
+
+        auto p = std::move(list.back());
+        list.pop_back();
+        return handle(std::move(p));
+    }
+
+    // number of free parsers of the current thread
+    static std::size_t size() { return free_list().size(); }
+
+private:
+    static void release(std::unique_ptr<parser> p) {
+        json_assert(p != nullptr);
+
+        auto& list = free_list();
+        if (list.size() < max_cached)
+            list.push_back(std::move(p));
+    }
+
+    static std::vector<std::unique_ptr<parser>>& free_list() {
+        static thread_local std::vector<std::unique_ptr<parser>> list;
+        return list;
+    }
+};
+} // namespace detail
+} // namespace microlife
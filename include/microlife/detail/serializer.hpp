@@ -0,0 +1,254 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+#include "number_formatter.hpp"
+#include "simd.hpp"
+#include "value_t.hpp"
+
+#include <cstddef>     // size_t
+#include <cstdint>     // int64_t, uint64_t
+#include <string_view> // string_view
+#include <vector>      // vector
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief writes JSON scalars to an output adapter
+ * @details Shared by the serializers of basic_json and basic_document.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename OutputAdapterType>
+class output_writer {
+private:
+    OutputAdapterType& m_output;
+
+public:
+    explicit output_writer(OutputAdapterType& output) : m_output(output) {}
+
+    void write_character(char c) { m_output.write_character(c); }
+
+    void write_characters(const char* s, std::size_t length) {
+        m_output.write_characters(s, length);
+    }
+
+    void write_null() { m_output.write_characters("null", 4); }
+
+    void write_boolean(bool b) {
+        if (b)
+            m_output.write_characters("true", 4);
+        else
+            m_output.write_characters("false", 5);
+    }
+
+    void write_number(double number) {
+        char buffer[number_formatter::buffer_size];
+        auto end = number_formatter::format_double(buffer, number);
+        m_output.write_characters(buffer, std::size_t(end - buffer));
+    }
+
+    void write_integer(std::int64_t number) {
+        char buffer[number_formatter::buffer_size];
+        auto end = number_formatter::format_signed(buffer, number);
+        m_output.write_characters(buffer, std::size_t(end - buffer));
+    }
+
+    void write_unsigned(std::uint64_t number) {
+        char buffer[number_formatter::buffer_size];
+        auto end = number_formatter::format_integer(buffer, number);
+        m_output.write_characters(buffer, std::size_t(end - buffer));
+    }
+
+    // a quoted string, clean runs between two escapes are found with
+    // simd::find_escape() and written at once
+    void write_string(const char* str, std::size_t len) {
+        static const char hex_digits[] = "0123456789ABCDEF";
+
+        m_output.write_character('\"');
+        const char* p = str;
+        const char* last = p + len;
+        while (true) {
+            const char* q = simd::find_escape(p, last);
+            m_output.write_characters(p, std::size_t(q - p));
+            if (q == last)
+                break;
+            p = q + 1;
+
+            auto ch = static_cast<unsigned char>(*q);
+            char escape[6] = {'\\', 0, 0, 0, 0, 0};
+            switch (ch) {
+            case '\"':
+                escape[1] = '\"';
+                break;
+            case '\\':
+                escape[1] = '\\';
+                break;
+            case '\b':
+                escape[1] = 'b';
+                break;
+            case '\f':
+                escape[1] = 'f';
+                break;
+            case '\n':
+                escape[1] = 'n';
+                break;
+            case '\r':
+                escape[1] = 'r';
+                break;
+            case '\t':
+                escape[1] = 't';
+                break;
+            default:
+                escape[1] = 'u';
+                escape[2] = '0';
+                escape[3] = '0';
+                escape[4] = hex_digits[ch >> 4];
+                escape[5] = hex_digits[ch & 15];
+                m_output.write_characters(escape, 6);
+                continue;
+            }
+            m_output.write_characters(escape, 2);
+        }
+        m_output.write_character('\"');
+    }
+};
+
+/***
+ * @brief JSON serializer
+ * @details Writes a basic_json to an output adapter (see output_adapter.hpp)
+ * in a single pass, no intermediate string is built. Nested arrays and
+ * objects are walked with an explicit stack instead of recursion, so
+ * writing a deeply nested value does not use the call stack (destroying
+ * one still does, see json_value::destroy()).
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename JsonType, typename OutputAdapterType>
+class serializer {
+public:
+    using basic_json = JsonType;
+    using string_t = typename basic_json::string_t;
+    using array_t = typename basic_json::array_t;
+    using object_t = typename basic_json::object_t;
+
+private:
+    // an array or object being written
+    struct frame {
+        const basic_json* value;
+        std::size_t index;                           // the current element
+        typename object_t::const_iterator member;    // the current member
+    };
+
+    output_writer<OutputAdapterType> m_output;
+    std::vector<frame> m_stack; // open arrays/objects, innermost last
+
+public:
+    explicit serializer(OutputAdapterType& output) : m_output(output) {}
+
+    // write the serialization of value
+    void dump(const basic_json& value) {
+        m_stack.clear();
+
+        const basic_json* cur = &value;
+        while (cur != nullptr) {
+            if (dump_value(*cur))
+                cur = first_child();
+            else
+                cur = next_value();
+        }
+    }
+
+private:
+    // write a scalar or the opening of a container
+    // returns whether a non-empty container was opened
+    bool dump_value(const basic_json& v) {
+        const auto value = v.m_data.value();
+        switch (v.type()) {
+        default:
+        case value_t::null:
+            m_output.write_null();
+            return false;
+
+        case value_t::boolean:
+            m_output.write_boolean(value.boolean);
+            return false;
+
+        case value_t::number:
+            m_output.write_number(value.number);
+            return false;
+
+        case value_t::number_integer:
+            m_output.write_integer(value.integer);
+            return false;
+
+        case value_t::number_unsigned:
+            m_output.write_unsigned(value.unsigned_integer);
+            return false;
+
+        case value_t::string: {
+            auto str = v.string_view();
+            m_output.write_string(str.data(), str.size());
+            return false;
+        }
+
+        case value_t::array:
+            if (value.array->empty()) {
+                m_output.write_characters("[]", 2);
+                return false;
+            }
+            m_output.write_character('[');
+            m_stack.push_back({&v, 0, {}});
+            return true;
+
+        case value_t::object:
+            if (value.object->empty()) {
+                m_output.write_characters("{}", 2);
+                return false;
+            }
+            m_output.write_character('{');
+            m_stack.push_back({&v, 0, value.object->begin()});
+            return true;
+        }
+    }
+
+    // the first value of the container just opened
+    const basic_json* first_child() {
+        auto& f = m_stack.back();
+        if (f.value->type() == value_t::array)
+            return &f.value->m_data.value().array->front();
+
+        dump_key(f.member->first);
+        return &f.member->second;
+    }
+
+    // the value after the one just written, closes finished containers
+    // returns nullptr at the end of the document
+    const basic_json* next_value() {
+        while (!m_stack.empty()) {
+            auto& f = m_stack.back();
+            if (f.value->type() == value_t::array) {
+                const auto& array = *f.value->m_data.value().array;
+                if (++f.index < array.size()) {
+                    m_output.write_character(',');
+                    return &array[f.index];
+                }
+                m_output.write_character(']');
+            } else {
+                if (++f.member != f.value->m_data.value().object->end()) {
+                    m_output.write_character(',');
+                    dump_key(f.member->first);
+                    return &f.member->second;
+                }
+                m_output.write_character('}');
+            }
+            m_stack.pop_back();
+        }
+        return nullptr;
+    }
+
+    void dump_key(std::string_view key) {
+        m_output.write_string(key.data(), key.size());
+        m_output.write_character(':');
+    }
+};
+} // namespace detail
+} // namespace microlife
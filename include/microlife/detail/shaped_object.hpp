@@ -0,0 +1,558 @@
+#pragma once
+#include "hybrid_object.hpp" // hybrid_object, ordered_object
+#include "key_table.hpp"     // interned_key
+#include "macro_scope.hpp"   // json_assert()
+
+#include <atomic>           // atomic
+#include <cstddef>          // size_t, ptrdiff_t
+#include <initializer_list> // initializer_list
+#include <iterator>         // random_access_iterator_tag
+#include <memory>           // allocator, allocator_traits, unique_ptr
+#include <mutex>            // mutex, lock_guard
+#include <string_view>      // string_view
+#include <type_traits>      // conditional, enable_if, is_convertible
+#include <utility>          // pair, forward, swap
+#include <vector>           // vector
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief the keys of an object, in order (a hidden class)
+ * @details Objects built with the same keys in the same order share one
+ * shape: the key list and its index are stored once, each object only
+ * keeps a pointer to the shape and a vector of values, the value of a key
+ * is at the slot (position) the shape gives for it.
+ * Shared shapes form a tree: add() follows the transition to the shape
+ * with one more key, created the first time it is needed. The first
+ * transitions of a shape are cached in an array that is read without
+ * locking, the others are found under a global mutex. Shared shapes are
+ * never freed (like interned keys), so the set of key sequences should be
+ * bounded.
+ * Objects with more than max_shared_size keys get a private shape that
+ * is owned, and modified in place, by a single object.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class object_shape {
+public:
+    // larger objects do not share their shape
+    static constexpr std::size_t max_shared_size = 64;
+    static constexpr std::size_t npos = std::size_t(-1);
+
+private:
+    // transitions read without locking
+    static constexpr std::size_t cached_transitions = 8;
+
+public:
+    // a key and an unused value, see keys()
+    using key_entry = std::pair<interned_key, bool>;
+
+private:
+    // the slot of a key is its position
+    ordered_object<interned_key, bool> m_keys;
+    bool m_shared;
+
+    // shared shapes only, children are created under tree_mutex()
+    hybrid_object<interned_key, std::unique_ptr<object_shape>> m_children;
+    std::atomic<object_shape*> m_recent[cached_transitions] = {};
+    std::size_t m_recent_size = 0;
+
+    explicit object_shape(bool shared) : m_shared(shared) {}
+
+public:
+    object_shape(const object_shape&) = delete;
+    object_shape& operator=(const object_shape&) = delete;
+
+    // the shared shape without keys
+    // never destroyed, objects with static storage may still point to it
+    static object_shape* empty() {
+        static object_shape* root = new object_shape(true);
+        return root;
+    }
+
+    bool shared() const noexcept { return m_shared; }
+    std::size_t size() const noexcept { return m_keys.size(); }
+
+    const interned_key& key(std::size_t slot) const noexcept {
+        return m_keys.data()[slot].first;
+    }
+
+    // the keys in slot order, keys()[slot].first
+    const key_entry* keys() const noexcept { return m_keys.data(); }
+
+    // the slot of key, npos if there is none
+    template <typename K>
+    std::size_t find(const K& key) const {
+        auto it = m_keys.find(key);
+        return it == m_keys.end() ? npos : std::size_t(it - m_keys.begin());
+    }
+
+    // the shape with key appended (key must not be present)
+    // a private shape is modified and returned
+    object_shape* add(interned_key key) {
+        if (!m_shared) {
+            m_keys.try_emplace(key, false);
+            return this;
+        }
+        if (size() >= max_shared_size) {
+            auto* ret = clone();
+            ret->m_keys.try_emplace(key, false);
+            return ret;
+        }
+
+        for (auto& i : m_recent) {
+            auto* child = i.load(std::memory_order_acquire);
+            if (child == nullptr)
+                break;
+            if (child->key(size()) == key)
+                return child;
+        }
+
+        std::lock_guard<std::mutex> lock(tree_mutex());
+        auto it = m_children.find(key);
+        if (it != m_children.end())
+            return it->second.get();
+
+        std::unique_ptr<object_shape> child(new object_shape(true));
+        child->m_keys = m_keys;
+        child->m_keys.try_emplace(key, false);
+        auto* ret = child.get();
+        m_children.try_emplace(key, std::move(child));
+        if (m_recent_size < cached_transitions)
+            m_recent[m_recent_size++].store(ret, std::memory_order_release);
+        return ret;
+    }
+
+    // the shape without the key at slot
+    // a private shape is modified and returned
+    object_shape* remove(std::size_t slot) {
+        json_assert(slot < size());
+        if (!m_shared) {
+            m_keys.erase(m_keys.begin() + slot);
+            return this;
+        }
+        object_shape* ret = empty();
+        for (std::size_t i = 0; i < size(); i++) {
+            if (i != slot)
+                ret = ret->add(key(i));
+        }
+        return ret;
+    }
+
+    // a private copy (for the object copying a private shape)
+    object_shape* clone() const {
+        auto* ret = new object_shape(false);
+        ret->m_keys = m_keys;
+        return ret;
+    }
+
+    // number of keys objects of this shape ended up with last time: the
+    // size reached by following the first transitions
+    std::size_t expected_size() const {
+        const object_shape* s = this;
+        while (auto* child = s->m_recent[0].load(std::memory_order_acquire))
+            s = child;
+        return s->size();
+    }
+
+private:
+    static std::mutex& tree_mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+};
+
+/***
+ * @brief a key that remembers its slot in the last shape it was found in
+ * @details Looking up the same member in many objects of the same shape
+ * (the rows of an array) costs one pointer comparison per object instead
+ * of a search. Only shared shapes are remembered: a private shape changes
+ * in place and its address may be reused once it is freed, so it is
+ * searched every time. Not thread-safe, use one per thread.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class member_key {
+private:
+    interned_key m_key;
+    mutable const object_shape* m_shape = nullptr;
+    mutable std::size_t m_slot = 0;
+
+public:
+    explicit member_key(std::string_view key) : m_key(key) {}
+
+    const interned_key& key() const noexcept { return m_key; }
+
+    // the slot of the key in shape, npos if there is none
+    std::size_t slot(const object_shape* shape) const {
+        if (!shape->shared())
+            return shape->find(m_key);
+        if (shape != m_shape) {
+            m_slot = shape->find(m_key);
+            m_shape = shape;
+        }
+        return m_slot;
+    }
+};
+
+/***
+ * @brief JSON object container: shared shape + packed values
+ * @details The keys live in an object_shape shared with every object that
+ * has the same keys in the same order, the object itself is a shape
+ * pointer and a vector of values. The rows of an array of records then
+ * store their keys once in total, and iterating or dumping them walks a
+ * contiguous vector. When the first member of an empty object is added,
+ * the values are reserved for the size the previous objects of that shape
+ * reached.
+ * Members iterate in insertion order. Iterators yield member references
+ * (first: the key, second: the value) by value, use `const auto&` or
+ * `auto&&` in range-for loops. Adding or erasing a member invalidates the
+ * iterators. Keys are interned_key, lookups accept anything convertible to
+ * std::string_view, an interned_key (compared by address) or a member_key.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class shaped_object {
+public:
+    using key_type = interned_key;
+    using mapped_type = T;
+    using value_type = std::pair<interned_key, T>;
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+private:
+    using value_vector = std::vector<
+        T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
+
+    static constexpr size_type npos = object_shape::npos;
+
+    // enables the lookup overloads for key types, not for iterators
+    template <typename K>
+    using if_key =
+        std::enable_if_t<std::is_convertible_v<const K&, std::string_view>,
+                         int>;
+
+    object_shape* m_shape = object_shape::empty();
+    value_vector m_values;
+
+public:
+    // a member, returned by value from the iterators
+    template <bool Const>
+    struct member_reference {
+        const interned_key& first;
+        std::conditional_t<Const, const T&, T&> second;
+    };
+
+    template <bool Const>
+    class basic_iterator {
+    private:
+        friend class shaped_object;
+        using key_entry = object_shape::key_entry;
+        using value_pointer = std::conditional_t<Const, const T*, T*>;
+
+        // the key and the value advance together
+        const key_entry* m_key = nullptr;
+        value_pointer m_value = nullptr;
+
+        basic_iterator(const key_entry* key, value_pointer value)
+            : m_key(key), m_value(value) {}
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = shaped_object::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = member_reference<Const>;
+
+        // operator-> of a reference returned by value
+        struct pointer {
+            reference ref;
+            const reference* operator->() const { return &ref; }
+        };
+
+        basic_iterator() = default;
+        // iterator -> const_iterator
+        template <bool C = Const, std::enable_if_t<C, int> = 0>
+        basic_iterator(const basic_iterator<false>& other)
+            : m_key(other.m_key), m_value(other.m_value) {}
+
+        reference operator*() const {
+            return reference{m_key->first, *m_value};
+        }
+        pointer operator->() const { return pointer{**this}; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        basic_iterator& operator++() {
+            ++m_key;
+            ++m_value;
+            return *this;
+        }
+        basic_iterator operator++(int) {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+        basic_iterator& operator--() {
+            --m_key;
+            --m_value;
+            return *this;
+        }
+        basic_iterator operator--(int) {
+            auto ret = *this;
+            --*this;
+            return ret;
+        }
+        basic_iterator& operator+=(difference_type n) {
+            m_key += n;
+            m_value += n;
+            return *this;
+        }
+        basic_iterator& operator-=(difference_type n) { return *this += -n; }
+        friend basic_iterator operator+(basic_iterator it, difference_type n) {
+            return it += n;
+        }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator-(const basic_iterator& lhs,
+                                         const basic_iterator& rhs) {
+            return lhs.m_value - rhs.m_value;
+        }
+
+        friend bool operator==(const basic_iterator& lhs,
+                               const basic_iterator& rhs) {
+            return lhs.m_value == rhs.m_value;
+        }
+        friend bool operator!=(const basic_iterator& lhs,
+                               const basic_iterator& rhs) {
+            return lhs.m_value != rhs.m_value;
+        }
+        friend bool operator<(const basic_iterator& lhs,
+                              const basic_iterator& rhs) {
+            return lhs.m_value < rhs.m_value;
+        }
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    shaped_object() = default;
+    explicit shaped_object(const allocator_type& alloc) : m_values(alloc) {}
+    shaped_object(const shaped_object& other)
+        : m_shape(copy_shape(other.m_shape)), m_values(other.m_values) {}
+    shaped_object(const shaped_object& other, const allocator_type& alloc)
+        : m_shape(copy_shape(other.m_shape)), m_values(other.m_values, alloc) {}
+    shaped_object(shaped_object&& other) noexcept
+        : m_shape(other.m_shape), m_values(std::move(other.m_values)) {
+        other.m_shape = object_shape::empty();
+        other.m_values.clear();
+    }
+    shaped_object(shaped_object&& other, const allocator_type& alloc)
+        : m_shape(other.m_shape),
+          m_values(std::move(other.m_values), alloc) {
+        other.m_shape = object_shape::empty();
+        other.m_values.clear();
+    }
+    shaped_object(std::initializer_list<value_type> init,
+                  const allocator_type& alloc = allocator_type())
+        : shaped_object(alloc) {
+        for (const auto& i : init)
+            emplace(i.first, i.second);
+    }
+
+    shaped_object& operator=(const shaped_object& other) {
+        if (this != &other) {
+            shaped_object copy(other, get_allocator());
+            swap(copy);
+        }
+        return *this;
+    }
+    shaped_object& operator=(shaped_object&& other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~shaped_object() { release_shape(); }
+
+    allocator_type get_allocator() const { return m_values.get_allocator(); }
+
+    // the shape of the object, shared with the objects of the same keys
+    const object_shape& shape() const noexcept { return *m_shape; }
+
+    iterator begin() noexcept { return at_slot(0); }
+    iterator end() noexcept { return at_slot(size()); }
+    const_iterator begin() const noexcept { return at_slot(0); }
+    const_iterator end() const noexcept { return at_slot(size()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    size_type size() const noexcept { return m_values.size(); }
+    bool empty() const noexcept { return m_values.empty(); }
+
+    void clear() noexcept {
+        release_shape();
+        m_shape = object_shape::empty();
+        m_values.clear();
+    }
+
+    void reserve(size_type n) { m_values.reserve(n); }
+
+    template <typename K, if_key<K> = 0>
+    iterator find(const K& key) {
+        return at_slot(m_shape->find(key));
+    }
+    template <typename K, if_key<K> = 0>
+    const_iterator find(const K& key) const {
+        return at_slot(m_shape->find(key));
+    }
+    iterator find(const member_key& key) { return at_slot(key.slot(m_shape)); }
+    const_iterator find(const member_key& key) const {
+        return at_slot(key.slot(m_shape));
+    }
+
+    template <typename K, if_key<K> = 0>
+    size_type count(const K& key) const {
+        return m_shape->find(key) == npos ? 0 : 1;
+    }
+    template <typename K, if_key<K> = 0>
+    bool contains(const K& key) const {
+        return m_shape->find(key) != npos;
+    }
+
+    template <typename K, if_key<K> = 0>
+    T& at(const K& key) {
+        auto slot = m_shape->find(key);
+        json_assert(slot != npos);
+        return m_values[slot];
+    }
+    template <typename K, if_key<K> = 0>
+    const T& at(const K& key) const {
+        auto slot = m_shape->find(key);
+        json_assert(slot != npos);
+        return m_values[slot];
+    }
+
+    template <typename K, if_key<K> = 0>
+    T& operator[](const K& key) {
+        return try_emplace(key).first->second;
+    }
+
+    // inserts (key, T(args...)) if key is not present
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        auto slot = m_shape->find(key);
+        if (slot != npos)
+            return {at_slot(slot), false};
+
+        interned_key k = intern(key);
+        if (m_shape->shared()) {
+            std::unique_ptr<object_shape> guard;
+            auto* shape = m_shape->add(k);
+            if (!shape->shared())
+                guard.reset(shape);
+            if (m_values.empty())
+                m_values.reserve(shape->expected_size());
+            m_values.emplace_back(std::forward<Args>(args)...);
+            guard.release();
+            m_shape = shape;
+        } else {
+            // a private shape changes in place, add the value first
+            m_values.emplace_back(std::forward<Args>(args)...);
+            try {
+                m_shape->add(k);
+            } catch (...) {
+                m_values.pop_back();
+                throw;
+            }
+        }
+        return {at_slot(size() - 1), true};
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace(const K& key, Args&&... args) {
+        return try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return try_emplace(value.first, value.second);
+    }
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return try_emplace(value.first, std::move(value.second));
+    }
+
+    // the following members move up, returns the iterator to the position
+    // of the erased member
+    iterator erase(const_iterator it) {
+        auto slot = size_type(it - cbegin());
+        erase_slot(slot);
+        return at_slot(slot);
+    }
+
+    template <typename K, if_key<K> = 0>
+    size_type erase(const K& key) {
+        auto slot = m_shape->find(key);
+        if (slot == npos)
+            return 0;
+        erase_slot(slot);
+        return 1;
+    }
+
+    void swap(shaped_object& other) noexcept {
+        std::swap(m_shape, other.m_shape);
+        m_values.swap(other.m_values);
+    }
+
+    // same members, in any order
+    friend bool operator==(const shaped_object& lhs, const shaped_object& rhs) {
+        if (lhs.size() != rhs.size())
+            return false;
+        if (lhs.m_shape == rhs.m_shape)
+            return lhs.m_values == rhs.m_values;
+        for (const auto& i : lhs) {
+            auto it = rhs.find(i.first);
+            if (it == rhs.end() || !(it->second == i.second))
+                return false;
+        }
+        return true;
+    }
+    friend bool operator!=(const shaped_object& lhs, const shaped_object& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    // npos: end()
+    iterator at_slot(size_type slot) noexcept {
+        if (slot == npos)
+            slot = size();
+        return iterator(m_shape->keys() + slot, m_values.data() + slot);
+    }
+    const_iterator at_slot(size_type slot) const noexcept {
+        if (slot == npos)
+            slot = size();
+        return const_iterator(m_shape->keys() + slot, m_values.data() + slot);
+    }
+
+    template <typename K>
+    static interned_key intern(const K& key) {
+        if constexpr (std::is_same_v<K, interned_key>)
+            return key;
+        else
+            return interned_key(std::string_view(key));
+    }
+
+    static object_shape* copy_shape(object_shape* shape) {
+        return shape->shared() ? shape : shape->clone();
+    }
+
+    void release_shape() noexcept {
+        if (!m_shape->shared())
+            delete m_shape;
+    }
+
+    void erase_slot(size_type slot) {
+        m_shape = m_shape->remove(slot);
+        m_values.erase(m_values.begin() + slot);
+    }
+};
+} // namespace detail
+} // namespace microlife
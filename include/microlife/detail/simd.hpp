@@ -0,0 +1,177 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+
+// x86 kernels, define JSON_NO_SIMD to use the scalar code only
+#if !defined(JSON_NO_SIMD) &&                                                  \
+    (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+     defined(_M_IX86))
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_HAS_SIMD_X86 1
+#endif
+#endif
+
+#if defined(JSON_HAS_SIMD_X86)
+#include <immintrin.h> // SSE2, AVX2
+#if defined(_MSC_VER)
+#include <intrin.h> // __cpuid, __cpuidex, _BitScanForward
+#define JSON_TARGET_AVX2
+#else
+#define JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief vectorized byte scans
+ * @details find_escape() returns the first byte of [first, last) that a
+ * JSON string can not hold as is: '"', '\\' or a control character below
+ * 0x20. The serializer copies the clean run before it in one piece, the
+ * lexer scans string contents with it.
+ * The kernel (AVX2, SSE2 or scalar) is selected once at runtime from the
+ * features of the CPU, the binary itself only needs SSE2.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class simd {
+public:
+    enum class level { scalar, sse2, avx2 };
+
+    using find_function = const char* (*)(const char*, const char*);
+
+private:
+    // shorter inputs are not worth a call through the function pointer
+    static constexpr std::size_t min_vector_length = 16;
+
+public:
+    static const char* find_escape(const char* first, const char* last) {
+        json_assert(first <= last);
+        if (std::size_t(last - first) < min_vector_length)
+            return find_escape_scalar(first, last);
+        return find_escape_function()(first, last);
+    }
+
+    // the best level supported by this CPU
+    static level detect() {
+#if defined(JSON_HAS_SIMD_X86)
+        if (cpu_has_avx2())
+            return level::avx2;
+        return level::sse2;
+#else
+        return level::scalar;
+#endif
+    }
+
+    // the kernel of a level, nullptr if it is not compiled in
+    static find_function find_escape_function(level l) {
+        switch (l) {
+#if defined(JSON_HAS_SIMD_X86)
+        case level::avx2:
+            return find_escape_avx2;
+        case level::sse2:
+            return find_escape_sse2;
+#endif
+        case level::scalar:
+            return find_escape_scalar;
+        default:
+            return nullptr;
+        }
+    }
+
+    static const char* find_escape_scalar(const char* first,
+                                          const char* last) {
+        for (; first != last; first++) {
+            if (needs_escape(*first))
+                return first;
+        }
+        return last;
+    }
+
+#if defined(JSON_HAS_SIMD_X86)
+    static const char* find_escape_sse2(const char* first, const char* last) {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i control = _mm_set1_epi8(0x1F);
+        for (; last - first >= 16; first += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+            // x <= 0x1F (unsigned) <=> min(x, 0x1F) == x
+            __m128i m = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(x, quote),
+                             _mm_cmpeq_epi8(x, backslash)),
+                _mm_cmpeq_epi8(_mm_min_epu8(x, control), x));
+            auto mask = std::uint32_t(_mm_movemask_epi8(m));
+            if (mask != 0)
+                return first + trailing_zeros(mask);
+        }
+        return find_escape_scalar(first, last);
+    }
+
+    JSON_TARGET_AVX2
+    static const char* find_escape_avx2(const char* first, const char* last) {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i control = _mm256_set1_epi8(0x1F);
+        for (; last - first >= 32; first += 32) {
+            __m256i x =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+            __m256i m = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(x, quote),
+                                _mm256_cmpeq_epi8(x, backslash)),
+                _mm256_cmpeq_epi8(_mm256_min_epu8(x, control), x));
+            auto mask = std::uint32_t(_mm256_movemask_epi8(m));
+            if (mask != 0)
+                return first + trailing_zeros(mask);
+        }
+        return find_escape_sse2(first, last);
+    }
+#endif
+
+private:
+    static bool needs_escape(char c) {
+        auto ch = static_cast<unsigned char>(c);
+        return ch < 0x20 || ch == '"' || ch == '\\';
+    }
+
+    static find_function find_escape_function() {
+        static const find_function f = find_escape_function(detect());
+        return f;
+    }
+
+#if defined(JSON_HAS_SIMD_X86)
+    // mask != 0
+    static int trailing_zeros(std::uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return int(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    static bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        // OSXSAVE and AVX, and the OS saves the YMM registers
+        const int osxsave_avx = (1 << 27) | (1 << 28);
+        if ((info[2] & osxsave_avx) != osxsave_avx ||
+            (_xgetbv(0) & 6) != 6)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+};
+} // namespace detail
+} // namespace microlife
@@ -0,0 +1,347 @@
+#pragma once
+#include "macro_scope.hpp" // json_assert()
+#include "simd.hpp"        // simd::level, JSON_HAS_SIMD_X86
+
+#include <array>   // array
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t, UINT32_MAX
+#include <cstring> // memcpy, memset
+#include <memory>  // unique_ptr
+#include <utility> // move
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief stage 1 of structural_parser: the positions of the tokens
+ * @details build() classifies the input 64 bytes at a time into bitmasks
+ * (quotes, backslashes, structural characters, whitespace, control
+ * characters), then finds with a few integer operations per block which
+ * quotes are escaped, which bytes are inside a string and where a
+ * number or literal begins. The positions of the set bits are written to
+ * a flat array:
+ * - `{ } [ ] : ,` outside of strings
+ * - the opening and the closing quote of every string
+ * - the first byte of every other run of non-whitespace (a scalar)
+ * so stage 2 jumps from token to token without looking at the bytes in
+ * between. build() fails on a string that is not closed or holds a
+ * control character, everything else is checked by stage 2.
+ * The classification kernel (AVX2, SSE2 or scalar) is selected once at
+ * runtime like simd::find_escape(), the rest is plain 64 bit arithmetic.
+ * The positions are 32 bits, longer inputs are rejected. The array is
+ * sized from the input (one token per few bytes) and doubled when a block
+ * could overflow it, it is not initialized and keeps its capacity.
+ * @author qingl
+ * @date 2026_10_17
+ */
+class structural_index {
+public:
+    using level = simd::level;
+
+    // the bytes of a block that are ...
+    struct block_masks {
+        std::uint64_t quote = 0;      // '"'
+        std::uint64_t backslash = 0;  // '\\'
+        std::uint64_t structural = 0; // { } [ ] : ,
+        std::uint64_t whitespace = 0; // space \t \n \r
+        std::uint64_t control = 0;    // below 0x20
+    };
+
+    using classify_function = void (*)(const char* block, block_masks& m);
+
+    static constexpr std::size_t block_size = 64;
+
+private:
+    std::unique_ptr<std::uint32_t[]> m_positions; // not initialized
+    std::size_t m_capacity = 0;
+    std::size_t m_size = 0;
+
+public:
+    // index [first, last) with the best kernel of this CPU
+    bool build(const char* first, const char* last) {
+        return build(first, last, classify_function_of(simd::detect()));
+    }
+
+    // index [first, last) with the kernel of level l, which must be
+    // supported by this CPU
+    bool build(const char* first, const char* last, level l) {
+        auto f = classify_function_of(l);
+        json_assert(f != nullptr);
+        return build(first, last, f);
+    }
+
+    const std::uint32_t* begin() const { return m_positions.get(); }
+    const std::uint32_t* end() const { return m_positions.get() + m_size; }
+    std::size_t size() const { return m_size; }
+
+    // the kernel of a level, nullptr if it is not compiled in
+    static classify_function classify_function_of(level l) {
+        switch (l) {
+#if defined(JSON_HAS_SIMD_X86)
+        case level::avx2:
+            return classify_avx2;
+        case level::sse2:
+            return classify_sse2;
+#endif
+        case level::scalar:
+            return classify_scalar;
+        default:
+            return nullptr;
+        }
+    }
+
+    static void classify_scalar(const char* block, block_masks& m) {
+        m = block_masks();
+        for (std::size_t i = 0; i < block_size; i++) {
+            const std::uint64_t bit = std::uint64_t(1) << i;
+            const unsigned char c = static_cast<unsigned char>(block[i]);
+            const std::uint8_t k = byte_classes()[c];
+            if (k & quote_class)
+                m.quote |= bit;
+            if (k & backslash_class)
+                m.backslash |= bit;
+            if (k & structural_class)
+                m.structural |= bit;
+            if (k & whitespace_class)
+                m.whitespace |= bit;
+            if (k & control_class)
+                m.control |= bit;
+        }
+    }
+
+#if defined(JSON_HAS_SIMD_X86)
+    static void classify_sse2(const char* block, block_masks& m) {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i case_bit = _mm_set1_epi8(0x20);
+        const __m128i open = _mm_set1_epi8('{');   // '[' | 0x20
+        const __m128i close = _mm_set1_epi8('}');  // ']' | 0x20
+        const __m128i colon = _mm_set1_epi8(':');
+        const __m128i comma = _mm_set1_epi8(',');
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i lf = _mm_set1_epi8('\n');
+        const __m128i cr = _mm_set1_epi8('\r');
+        const __m128i control = _mm_set1_epi8(0x1F);
+
+        m = block_masks();
+        for (int i = 0; i < 4; i++) {
+            __m128i x =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(block) + i);
+            __m128i folded = _mm_or_si128(x, case_bit);
+            __m128i s = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(folded, open),
+                             _mm_cmpeq_epi8(folded, close)),
+                _mm_or_si128(_mm_cmpeq_epi8(x, colon),
+                             _mm_cmpeq_epi8(x, comma)));
+            __m128i w = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(x, space),
+                             _mm_cmpeq_epi8(x, tab)),
+                _mm_or_si128(_mm_cmpeq_epi8(x, lf), _mm_cmpeq_epi8(x, cr)));
+            const int shift = 16 * i;
+            m.quote |= bits(_mm_movemask_epi8(_mm_cmpeq_epi8(x, quote)),
+                            shift);
+            m.backslash |= bits(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(x, backslash)), shift);
+            m.structural |= bits(_mm_movemask_epi8(s), shift);
+            m.whitespace |= bits(_mm_movemask_epi8(w), shift);
+            // x <= 0x1F (unsigned) <=> min(x, 0x1F) == x
+            m.control |= bits(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                                  _mm_min_epu8(x, control), x)),
+                              shift);
+        }
+    }
+
+    JSON_TARGET_AVX2
+    static void classify_avx2(const char* block, block_masks& m) {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i case_bit = _mm256_set1_epi8(0x20);
+        const __m256i open = _mm256_set1_epi8('{');
+        const __m256i close = _mm256_set1_epi8('}');
+        const __m256i colon = _mm256_set1_epi8(':');
+        const __m256i comma = _mm256_set1_epi8(',');
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i lf = _mm256_set1_epi8('\n');
+        const __m256i cr = _mm256_set1_epi8('\r');
+        const __m256i control = _mm256_set1_epi8(0x1F);
+
+        m = block_masks();
+        for (int i = 0; i < 2; i++) {
+            __m256i x = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(block) + i);
+            __m256i folded = _mm256_or_si256(x, case_bit);
+            __m256i s = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(folded, open),
+                                _mm256_cmpeq_epi8(folded, close)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(x, colon),
+                                _mm256_cmpeq_epi8(x, comma)));
+            __m256i w = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(x, space),
+                                _mm256_cmpeq_epi8(x, tab)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(x, lf),
+                                _mm256_cmpeq_epi8(x, cr)));
+            const int shift = 32 * i;
+            m.quote |= bits(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, quote)), shift);
+            m.backslash |= bits(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, backslash)), shift);
+            m.structural |= bits(_mm256_movemask_epi8(s), shift);
+            m.whitespace |= bits(_mm256_movemask_epi8(w), shift);
+            m.control |= bits(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                                  _mm256_min_epu8(x, control), x)),
+                              shift);
+        }
+    }
+#endif
+
+private:
+    enum : std::uint8_t {
+        quote_class = 1,
+        backslash_class = 2,
+        structural_class = 4,
+        whitespace_class = 8,
+        control_class = 16
+    };
+
+    // the classes of every byte value, for the scalar kernel
+    static const std::array<std::uint8_t, 256>& byte_classes() {
+        static const std::array<std::uint8_t, 256> table = [] {
+            std::array<std::uint8_t, 256> t{};
+            for (int c = 0; c < 0x20; c++)
+                t[c] |= control_class;
+            t['"'] |= quote_class;
+            t['\\'] |= backslash_class;
+            for (unsigned char c : {'{', '}', '[', ']', ':', ','})
+                t[c] |= structural_class;
+            for (unsigned char c : {' ', '\t', '\n', '\r'})
+                t[c] |= whitespace_class;
+            return t;
+        }();
+        return table;
+    }
+
+    // movemask bits at position shift of the block
+    static std::uint64_t bits(int mask, int shift) {
+        return std::uint64_t(std::uint32_t(mask)) << shift;
+    }
+
+    // bits != 0
+    static int trailing_zeros(std::uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return int(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    // bit i = xor of the bits 0..i: the bytes from an opening quote up
+    // to (not including) its closing quote
+    static std::uint64_t prefix_xor(std::uint64_t bits) {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    // the bytes escaped by a backslash; carry: the first byte of the block
+    // is escaped by the last byte of the previous one, updated for the next
+    // block. Backslashes are rare, they are visited one escape at a time.
+    static std::uint64_t escaped_bytes(std::uint64_t backslash,
+                                       std::uint64_t& carry) {
+        std::uint64_t escaped = carry;
+        std::uint64_t pending = backslash & ~carry;
+        carry = 0;
+        while (pending != 0) {
+            int i = trailing_zeros(pending);
+            if (i == 63) {
+                carry = 1;
+                break;
+            }
+            escaped |= std::uint64_t(2) << i;
+            // the escaped byte does not start an escape, even a backslash
+            pending &= ~(std::uint64_t(3) << i);
+        }
+        return escaped;
+    }
+
+    // room for n positions, the first m_size are kept
+    void reserve(std::size_t n) {
+        if (n <= m_capacity)
+            return;
+        std::unique_ptr<std::uint32_t[]> positions(new std::uint32_t[n]);
+        if (m_size != 0)
+            std::memcpy(positions.get(), m_positions.get(),
+                        m_size * sizeof(std::uint32_t));
+        m_positions = std::move(positions);
+        m_capacity = n;
+    }
+
+    bool build(const char* first, const char* last, classify_function f) {
+        const std::size_t len = std::size_t(last - first);
+        m_size = 0;
+        if (len > UINT32_MAX)
+            return false;
+        // a first guess, grown by the blocks that need more
+        reserve(len / 8 + block_size);
+        std::uint32_t* out = m_positions.get();
+
+        std::uint64_t escape_carry = 0;
+        std::uint64_t in_string_carry = 0; // all ones inside a string
+        std::uint64_t scalar_carry = 0;    // the last byte was a scalar
+        std::uint64_t errors = 0;
+        block_masks m;
+        char tail[block_size];
+
+        for (std::size_t offset = 0; offset < len; offset += block_size) {
+            const char* block = first + offset;
+            if (len - offset < block_size) {
+                // the last block, padded with whitespace
+                std::memset(tail, ' ', block_size);
+                std::memcpy(tail, block, len - offset);
+                block = tail;
+            }
+            f(block, m);
+            // at most one position per byte of the block
+            if (m_capacity - std::size_t(out - m_positions.get()) <
+                block_size) {
+                m_size = std::size_t(out - m_positions.get());
+                reserve(m_capacity * 2);
+                out = m_positions.get() + m_size;
+            }
+
+            std::uint64_t escaped = escaped_bytes(m.backslash, escape_carry);
+            std::uint64_t quotes = m.quote & ~escaped;
+            std::uint64_t in_string = prefix_xor(quotes) ^ in_string_carry;
+            in_string_carry =
+                std::uint64_t(std::int64_t(in_string) >> 63);
+            errors |= m.control & in_string;
+
+            std::uint64_t string_bytes = in_string | quotes;
+            std::uint64_t scalar =
+                ~(m.structural | m.whitespace | string_bytes);
+            std::uint64_t scalar_start =
+                scalar & ~((scalar << 1) | scalar_carry);
+            scalar_carry = scalar >> 63;
+
+            std::uint64_t structurals =
+                (m.structural & ~string_bytes) | quotes | scalar_start;
+            const auto base = std::uint32_t(offset);
+            while (structurals != 0) {
+                *out++ = base + std::uint32_t(trailing_zeros(structurals));
+                structurals &= structurals - 1;
+            }
+        }
+
+        m_size = std::size_t(out - m_positions.get());
+        // a control character in a string, or a string not closed
+        return errors == 0 && in_string_carry == 0;
+    }
+};
+} // namespace detail
+} // namespace microlife
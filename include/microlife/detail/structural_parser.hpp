@@ -0,0 +1,256 @@
+#pragma once
+#include "input_adapter.hpp"    // contiguous_input_adapter
+#include "json_sax.hpp"         // json_sax_dom_parser, has_string_text
+#include "lexer.hpp"            // lexer
+#include "macro_scope.hpp"      // json_assert()
+#include "parser.hpp"           // parser::parse_number(), parse_string()
+#include "structural_index.hpp" // structural_index
+#include "token_t.hpp"          // token_t
+
+#include <cstdint>     // uint32_t
+#include <cstring>     // memchr
+#include <string_view> // string_view
+#include <vector>      // vector
+
+namespace microlife {
+namespace detail {
+/***
+ * @brief two stage JSON parser for contiguous inputs
+ * @details An alternative to parser for large inputs in memory, with the
+ * same SAX interface (see json_sax.hpp) and the same results.
+ * Stage 1 (structural_index) finds the position of every token with SIMD.
+ * Stage 2 walks these positions: the kind of a token is its first byte, a
+ * string without escapes is the range between its two quotes, nothing
+ * looks at the bytes in between. Only numbers, literals and strings with
+ * escapes go through the lexer, limited to the range of their token.
+ * The index needs 4 bytes per token and is kept for the next input, the
+ * input is limited to 4 GiB.
+ * @author qingl
+ * @date 2026_10_17
+ */
+template <typename JsonType>
+class structural_parser {
+private:
+    using basic_json = JsonType;
+    using string_t = typename basic_json::string_t;
+
+    using lexer = ::microlife::detail::lexer<basic_json>;
+    using parser = ::microlife::detail::parser<::microlife::detail::lexer,
+                                               basic_json>;
+    using token_t = ::microlife::detail::token_t;
+    using dom_parser = ::microlife::detail::json_sax_dom_parser<basic_json>;
+    using position = const std::uint32_t*;
+
+    // handler of accept(): checks, stores nothing
+    struct null_handler {
+        bool null() { return true; }
+        bool boolean(bool) { return true; }
+        bool number(typename basic_json::number_t) { return true; }
+        bool raw_strings() const { return true; }
+        bool string_text(std::string_view, bool) { return true; }
+        bool key_text(std::string_view, bool) { return true; }
+        bool string(string_t&) { return true; }
+        bool key(string_t&) { return true; }
+        bool start_object() { return true; }
+        bool end_object() { return true; }
+        bool start_array() { return true; }
+        bool end_array() { return true; }
+    };
+
+    structural_index m_index;
+    std::string_view m_input;
+    lexer m_lexer;              // numbers, literals, strings with escapes
+    string_t m_buffer;          // strings without escapes
+    std::vector<char> m_states; // open arrays/objects: '[' or '{'
+    dom_parser m_dom;           // handler used by parse()
+
+public:
+    // parse input into json, json is untouched on failure
+    bool parse(std::string_view input, basic_json& json) {
+        basic_json result(json.get_allocator());
+        m_dom.reset(result);
+
+        auto ret = sax_parse(input, &m_dom);
+        if (ret)
+            json = std::move(result);
+        return ret;
+    }
+
+    // parse input and report the values to sax
+    template <typename SAX>
+    bool sax_parse(std::string_view input, SAX* sax) {
+        json_assert(sax != nullptr);
+        // on entry: a handler that threw left the states of its parse
+        m_states.clear();
+        if (!m_index.build(input.data(), input.data() + input.size()))
+            return false;
+        m_input = input;
+        m_lexer.raw_numbers(parser::wants_number_text(sax));
+        m_lexer.raw_strings(parser::wants_string_text(sax));
+        return walk(sax);
+    }
+
+    // input is valid JSON, strings are checked but not copied
+    bool accept(std::string_view input) {
+        null_handler sax;
+        return sax_parse(input, &sax);
+    }
+
+    // the memory of the index back to the heap
+    void release() { m_index = structural_index(); }
+
+private:
+    // stage 2, the same state machine as parser::sax_parse_internal()
+    template <typename SAX>
+    bool walk(SAX* sax) {
+        position p = m_index.begin();
+        const position end = m_index.end();
+        // the first byte of the token at p, '\0' at the end
+        auto token = [&]() { return p == end ? '\0' : m_input[*p]; };
+
+        while (true) {
+            // 1. p is the first token of a value
+            switch (token()) {
+            case '[':
+                if (!sax->start_array())
+                    return false;
+                if (++p != end && m_input[*p] == ']') {
+                    p++;
+                    if (!sax->end_array())
+                        return false;
+                    break;
+                }
+                // descend into the first element
+                m_states.push_back('[');
+                continue;
+
+            case '{':
+                if (!sax->start_object())
+                    return false;
+                if (++p != end && m_input[*p] == '}') {
+                    p++;
+                    if (!sax->end_object())
+                        return false;
+                    break;
+                }
+                // descend into the first member
+                m_states.push_back('{');
+                if (!parse_key(p, end, sax))
+                    return false;
+                continue;
+
+            case '"':
+                if (!parse_string(p, sax, false))
+                    return false;
+                break;
+
+            case ']':
+            case '}':
+            case ':':
+            case ',':
+            case '\0':
+                return false;
+
+            default:
+                if (!parse_scalar(p, end, sax))
+                    return false;
+                break;
+            }
+
+            // 2. the value is complete, close containers until we find the
+            // next value
+            while (true) {
+                if (m_states.empty())
+                    return p == end;
+                const char c = token();
+                if (c == '\0')
+                    return false;
+                p++;
+
+                if (m_states.back() == '[') {
+                    if (c == ',')
+                        break;
+                    if (c != ']' || !sax->end_array())
+                        return false;
+                } else {
+                    if (c == ',') {
+                        if (!parse_key(p, end, sax))
+                            return false;
+                        break;
+                    }
+                    if (c != '}' || !sax->end_object())
+                        return false;
+                }
+                m_states.pop_back();
+            }
+        }
+    }
+
+    // p is the key of a member: `string ':'`, move p to the value
+    template <typename SAX>
+    bool parse_key(position& p, position end, SAX* sax) {
+        if (p == end || m_input[*p] != '"' || !parse_string(p, sax, true))
+            return false;
+        if (p == end || m_input[*p] != ':')
+            return false;
+        p++;
+        return true;
+    }
+
+    // p is an opening quote, the next position is its closing quote
+    template <typename SAX>
+    bool parse_string(position& p, SAX* sax, bool is_key) {
+        json_assert(p + 1 < m_index.end() && m_input[p[1]] == '"');
+        const char* first = m_input.data() + p[0] + 1;
+        const char* last = m_input.data() + p[1];
+        p += 2;
+
+        if (std::memchr(first, '\\', std::size_t(last - first)) != nullptr) {
+            // the lexer checks and decodes the escapes
+            m_lexer.init(contiguous_input_adapter(first - 1, last + 1));
+            if (m_lexer.scan() != token_t::value_string)
+                return false;
+            return parser::parse_string(m_lexer, sax, is_key);
+        }
+
+        // stage 1 checked the control characters
+        if constexpr (has_string_text<SAX>::value) {
+            if (m_lexer.raw_strings()) {
+                std::string_view text(first, std::size_t(last - first));
+                return is_key ? sax->key_text(text, false)
+                              : sax->string_text(text, false);
+            }
+        }
+        m_buffer.assign(first, last);
+        return is_key ? sax->key(m_buffer) : sax->string(m_buffer);
+    }
+
+    // p is a number or a literal, it ends before the next token
+    template <typename SAX>
+    bool parse_scalar(position& p, position end, SAX* sax) {
+        const char* first = m_input.data() + *p;
+        p++;
+        const char* last =
+            m_input.data() + (p == end ? m_input.size() : std::size_t(*p));
+        m_lexer.init(contiguous_input_adapter(first, last));
+        const token_t t = m_lexer.scan();
+        // only whitespace up to the next token
+        if (m_lexer.scan() != token_t::end_of_input)
+            return false;
+
+        switch (t) {
+        case token_t::literal_null:
+            return sax->null();
+        case token_t::literal_true:
+            return sax->boolean(true);
+        case token_t::literal_false:
+            return sax->boolean(false);
+        case token_t::value_number:
+            return parser::parse_number(m_lexer, sax);
+        default:
+            return false;
+        }
+    }
+};
+} // namespace detail
+} // namespace microlife
@@ -7,6 +7,9 @@ namespace microlife {
 namespace detail {
 /***
  * @brief JSON value type
+ * @details A number is one of number (a double), number_integer (fits
+ * std::int64_t) or number_unsigned (above INT64_MAX). The integer kinds
+ * come last so that the other values keep their tags.
  * @author qingl
  * @date 2022_04_09
  */
@@ -16,7 +19,9 @@ enum class value_t : uint8_t {
     number,
     string,
     array,
-    object
+    object,
+    number_integer,
+    number_unsigned
 };
 
 /***
@@ -44,6 +49,12 @@ inline std::ostream& operator<<(std::ostream& os, const value_t type) {
     case value_t::string:
         return os << "string";
 
+    case value_t::number_integer:
+        return os << "number_integer";
+
+    case value_t::number_unsigned:
+        return os << "number_unsigned";
+
     default:
         return os << "unknown type_t";
     }
@@ -55,9 +66,11 @@ inline std::ostream& operator<<(std::ostream& os, const value_t type) {
  * @date 2022_04_19
  */
 inline bool operator<(const value_t lhs, const value_t rhs) noexcept {
-    static constexpr std::array<std::uint8_t, 6> order = {{
+    // the three kinds of numbers have the same rank
+    static constexpr std::array<std::uint8_t, 8> order = {{
         0 /* null */, 1 /* boolean */, 2 /* number */, 3 /* string */,
-        4 /* array */, 5 /* object */
+        4 /* array */, 5 /* object */, 2 /* number_integer */,
+        2 /* number_unsigned */
     }};
 
     const auto l_index = static_cast<std::size_t>(lhs);
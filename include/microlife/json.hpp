@@ -1,4 +1,5 @@
 #include "microlife/detail/basic_json.hpp"
+#include "microlife/detail/document.hpp"
 
 /***
  * @brief JSON
@@ -6,7 +7,55 @@
  * @date 2022_04_15
  */
 namespace microlife {
-using json = ::microlife::detail::basic_json;
-}
+using json = ::microlife::detail::basic_json<>;
+
+// SAX interface, see json::sax_parse()
+using json_sax = ::microlife::detail::json_sax<json>;
+
+// read-only document backed by an arena, see basic_document
+using document = ::microlife::detail::basic_document;
+
+// two stage parser for inputs in memory (SIMD index of the tokens, then
+// the values), see structural_parser
+using structural_parser = ::microlife::detail::structural_parser<json>;
+
+// json keeping the members of objects in insertion order, see
+// ordered_json_policy
+using ordered_json =
+    ::microlife::detail::basic_json<::microlife::detail::ordered_json_policy>;
+
+// ordered_json with interned keys, see interned_json_policy and key_table
+using interned_json =
+    ::microlife::detail::basic_json<::microlife::detail::interned_json_policy>;
+
+// json whose objects share their keys by shape, see shaped_json_policy
+using shaped_json =
+    ::microlife::detail::basic_json<::microlife::detail::shaped_json_policy>;
+
+namespace pmr {
+// json allocating from a std::pmr::memory_resource, see pmr_json_policy
+using json =
+    ::microlife::detail::basic_json<::microlife::detail::pmr_json_policy>;
+
+using json_sax = ::microlife::detail::json_sax<json>;
+} // namespace pmr
+
+namespace compact {
+// json storing every value in 8 bytes (NaN-boxing), see compact_json_policy
+using json =
+    ::microlife::detail::basic_json<::microlife::detail::compact_json_policy>;
+
+using json_sax = ::microlife::detail::json_sax<json>;
+} // namespace compact
+
+namespace sso {
+// json keeping strings of up to 14 bytes inside the node, see
+// small_string_json_policy; read strings with get<std::string_view>()
+using json = ::microlife::detail::basic_json<
+    ::microlife::detail::small_string_json_policy>;
+
+using json_sax = ::microlife::detail::json_sax<json>;
+} // namespace sso
+} // namespace microlife
 
 #include "microlife/detail/macro_unscope.hpp"
@@ -0,0 +1,61 @@
+#include "microlife/detail/arena.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // uintptr_t
+#include <string>  // pmr::string
+#include <vector>  // pmr::vector
+
+using arena = microlife::detail::arena;
+
+TEST(arena, allocate) {
+    arena a;
+    EXPECT_EQ(0u, a.capacity());
+
+    // alignment
+    for (std::size_t align : {1, 2, 4, 8, 16, 64}) {
+        a.allocate_bytes(1, 1);
+        auto p = a.allocate_bytes(3, align);
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(p) % align);
+    }
+
+    // larger than a chunk
+    auto big = static_cast<char*>(a.allocate_bytes(100000, 8));
+    big[0] = big[99999] = 'x';
+    EXPECT_GE(a.capacity(), 100000u);
+
+    auto s = a.copy_string("hello", 5);
+    EXPECT_STREQ("hello", s);
+}
+
+TEST(arena, reset) {
+    arena a;
+    for (int i = 0; i < 1000; i++)
+        a.allocate_bytes(100, 8);
+    EXPECT_GE(a.used(), 100000u);
+    std::size_t capacity = a.capacity();
+
+    // the chunks are merged into one, the same work fits without growing
+    a.reset();
+    EXPECT_EQ(0u, a.used());
+    EXPECT_EQ(capacity, a.capacity());
+    for (int i = 0; i < 1000; i++)
+        a.allocate_bytes(100, 8);
+    EXPECT_EQ(capacity, a.capacity());
+
+    a.release();
+    EXPECT_EQ(0u, a.capacity());
+}
+
+TEST(arena, memory_resource) {
+    arena a;
+    {
+        std::pmr::vector<std::pmr::string> v(&a);
+        for (int i = 0; i < 100; i++)
+            v.emplace_back(std::string(50, char('a' + i % 26)));
+        EXPECT_EQ(std::string(50, 'a'), std::string(v[0]));
+        EXPECT_EQ(std::string(50, 'v'), std::string(v[99]));
+    }
+    EXPECT_GT(a.used(), 100u * 50u);
+    EXPECT_TRUE(a.is_equal(a));
+}
@@ -3,8 +3,9 @@
 #include "microlife/detail/basic_json.hpp"
 
 #include <gtest/gtest.h>
+#include <thread> // thread
 
-using basic_json = microlife::detail::basic_json;
+using basic_json = microlife::detail::basic_json<>;
 using json_value = basic_json::json_value;
 using value_t = basic_json::value_t;
 using array_t = basic_json::array_t;
@@ -68,3 +69,61 @@ TEST(basic_json, parser) {
     j = object_t({{"v", array_t({object_t({{"a", nullptr}})})}});
     TEST_PARSER(j, "{\"v\":[{\"a\":null}]}");
 }
+
+TEST(basic_json, parse_threads) {
+    // every thread parses its own documents at the same time
+    const int threads = 4, rounds = 200;
+    std::vector<int> ok(threads, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([t, &ok] {
+            for (int i = 0; i < rounds; i++) {
+                auto n = std::to_string(t * rounds + i);
+                basic_json j;
+                if (j.parse("{\"n\":" + n + ",\"s\":[\"" + n + "\"]}") &&
+                    j.get<object_t&>().at("n").get<int>() == t * rounds + i &&
+                    j.get<object_t&>().at("s").get<array_t&>()[0] ==
+                        basic_json(n))
+                    ok[t]++;
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    for (int t = 0; t < threads; t++)
+        EXPECT_EQ(rounds, ok[t]);
+}
+
+namespace {
+// parses every string value again while the outer parse is running
+struct sax_nested {
+    int nested = 0;
+
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool number(double) { return true; }
+    bool string(string_t& val) {
+        basic_json j;
+        if (!j.parse(val) || !j.is_array())
+            return false;
+        nested += int(j.get<array_t&>().size());
+        return true;
+    }
+    bool start_object() { return true; }
+    bool key(string_t&) { return true; }
+    bool end_object() { return true; }
+    bool start_array() { return true; }
+    bool end_array() { return true; }
+};
+} // namespace
+
+TEST(basic_json, parse_reentrant) {
+    sax_nested sax;
+    EXPECT_TRUE(basic_json::sax_parse("[\"[1,2]\",{\"a\":\"[3]\"}]", &sax));
+    EXPECT_EQ(3, sax.nested);
+
+    // the outer parse still works after the nested ones
+    sax.nested = 0;
+    EXPECT_FALSE(basic_json::sax_parse("[\"[1,2]\",\"[\"]", &sax));
+    EXPECT_EQ(2, sax.nested);
+}
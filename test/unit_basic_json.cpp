@@ -5,7 +5,7 @@
 
 #include <gtest/gtest.h>
 
-using basic_json = microlife::detail::basic_json;
+using basic_json = microlife::detail::basic_json<>;
 using json_value = basic_json::json_value;
 using value_t = basic_json::value_t;
 using array_t = basic_json::array_t;
@@ -31,9 +31,9 @@ TEST(basic_json, json_value) {
     // constructor
     TEST_JSON_VALUE_CONSTRUCTOR_BASE(true, true, boolean);
     TEST_JSON_VALUE_CONSTRUCTOR_BASE(false, false, boolean);
-    TEST_JSON_VALUE_CONSTRUCTOR_BASE(0, 0, number);
-    TEST_JSON_VALUE_CONSTRUCTOR_BASE(-10, -10, number);
-    TEST_JSON_VALUE_CONSTRUCTOR_BASE(123, 123, number);
+    TEST_JSON_VALUE_CONSTRUCTOR_BASE(0, 0, integer);
+    TEST_JSON_VALUE_CONSTRUCTOR_BASE(-10, -10, integer);
+    TEST_JSON_VALUE_CONSTRUCTOR_BASE(123, 123, integer);
     TEST_JSON_VALUE_CONSTRUCTOR_BASE(3.1415, 3.1415, number);
 
     std::string s1 = "json_value constructor test";
@@ -254,6 +254,8 @@ TEST(basic_json, value_t) {
     TEST_OS_VALUE_T("number", number);
     TEST_OS_VALUE_T("object", object);
     TEST_OS_VALUE_T("string", string);
+    TEST_OS_VALUE_T("number_integer", number_integer);
+    TEST_OS_VALUE_T("number_unsigned", number_unsigned);
 
     // unknown type
     std::ostringstream osstring;
@@ -323,3 +325,45 @@ TEST(basic_json, public_functions) {
     o2 = {{"a", 1}, {"b", 10}};
     EXPECT_TRUE(basic_json::compare(o2, o1) == 1);
 }
+
+TEST(basic_json, object_access) {
+    basic_json j;
+    ASSERT_TRUE(j.parse("{\"a\":1,\"b\":\"str\",\"c\":[true,null]}"));
+
+    EXPECT_TRUE(j.contains("a"));
+    EXPECT_FALSE(j.contains("d"));
+    EXPECT_EQ(nullptr, j.find("d"));
+    ASSERT_NE(nullptr, j.find("b"));
+    EXPECT_EQ("str", j.find("b")->get<string_t>());
+    EXPECT_EQ(1, j.at("a").get<int>());
+    // keys are not null-terminated views
+    EXPECT_TRUE(j.at(std::string_view("abc").substr(2, 1))[0].get<bool>());
+
+    // value(key, default)
+    EXPECT_EQ(1, j.value("a", 0));
+    EXPECT_EQ(7, j.value("d", 7));
+    EXPECT_EQ(2.5, j.value("d", 2.5));
+    EXPECT_EQ("str", j.value("b", "default"));
+    EXPECT_EQ("default", j.value("d", "default"));
+
+    // operator[] inserts null
+    j["d"] = 4;
+    EXPECT_EQ(4, j["d"].get<int>());
+    EXPECT_TRUE(j["e"].is_null());
+    EXPECT_EQ(5u, j.get<object_t&>().size());
+
+    // a null value becomes an object
+    basic_json k;
+    k["x"]["y"] = true;
+    EXPECT_EQ("{\"x\":{\"y\":true}}", k.dump());
+
+    // not an object
+    basic_json n(1);
+    EXPECT_FALSE(n.contains("a"));
+    EXPECT_EQ(nullptr, n.find("a"));
+
+    const basic_json& c = j;
+    EXPECT_EQ(1, c.at("a").get<int>());
+    EXPECT_EQ("str", c.at("b").get<const string_t&>());
+    EXPECT_TRUE(c.at("c")[0].get<bool>());
+}
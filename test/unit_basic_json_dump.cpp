@@ -4,7 +4,7 @@
 
 #include <gtest/gtest.h>
 
-using basic_json = microlife::detail::basic_json;
+using basic_json = microlife::detail::basic_json<>;
 using json_value = basic_json::json_value;
 using value_t = basic_json::value_t;
 using array_t = basic_json::array_t;
@@ -35,13 +35,22 @@ TEST(basic_json, dump) {
     TEST_DUMP_SAME("1e+20");
     TEST_DUMP_SAME("1.234e+20");
     TEST_DUMP_SAME("1.234e-20");
+    TEST_DUMP_SAME("0.1");
+    TEST_DUMP_SAME("0.0001");
+    TEST_DUMP_SAME("1e-05");
+    TEST_DUMP_SAME("12345678901234568");
+    TEST_DUMP_SAME("1e+17");
+    TEST_DUMP_BASE("1e+20", "100000000000000000000");
+    TEST_DUMP_BASE("0.3", "0.29999999999999998889776975");
+    TEST_DUMP_BASE("100", "1e2");
 
-    // not pass
+    // 最短的可以还原的表示
     TEST_DUMP_SAME("1.0000000000000002");      // the smallest number > 1
-    TEST_DUMP_SAME("4.9406564584124654e-324"); // minimum denormal
-    TEST_DUMP_SAME("-4.9406564584124654e-324");
-    TEST_DUMP_SAME("2.2250738585072009e-308"); // Max subnormal double
-    TEST_DUMP_SAME("-2.2250738585072009e-308");
+    TEST_DUMP_BASE("5e-324", "4.9406564584124654e-324"); // minimum denormal
+    TEST_DUMP_BASE("-5e-324", "-4.9406564584124654e-324");
+    TEST_DUMP_BASE("2.225073858507201e-308",
+                   "2.2250738585072009e-308"); // Max subnormal double
+    TEST_DUMP_BASE("-2.225073858507201e-308", "-2.2250738585072009e-308");
     TEST_DUMP_SAME("2.2250738585072014e-308"); // Min normal positive double
     TEST_DUMP_SAME("-2.2250738585072014e-308");
     TEST_DUMP_SAME("1.7976931348623157e+308"); // Max double
@@ -56,13 +65,12 @@ TEST(basic_json, dump) {
 
     // array
     TEST_DUMP_SAME("[]");
-    TEST_DUMP_BASE("[[3,2,1],\"abc\",123,true,false,null]",
-                   "[null,false,true,123,\"abc\",[1,2,3]]");
+    TEST_DUMP_SAME("[null,false,true,123,\"abc\",[1,2,3]]");
 
     // object
     TEST_DUMP_SAME("{}");
     TEST_DUMP_BASE(
-        "{\"a\":[3,2,1],\"f\":false,\"i\":123,\"n\":null,\"o\":{\"1\":1,\"2\":"
+        "{\"a\":[1,2,3],\"f\":false,\"i\":123,\"n\":null,\"o\":{\"1\":1,\"2\":"
         "2,\"3\":3},\"s\":\"abc\",\"t\":true}",
         "{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,"
         "3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}");
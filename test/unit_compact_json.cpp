@@ -0,0 +1,126 @@
+#define JSON_TESTS_PRIVATE
+
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>  // isnan
+#include <limits> // numeric_limits
+
+using compact_json = microlife::compact::json;
+using value_t = compact_json::value_t;
+using json_value = microlife::detail::basic_json<>::json_value;
+using storage = microlife::detail::nan_boxed_storage<json_value>;
+
+namespace {
+const char* const text =
+    "{\"a\":[1,-2.5,\"x\\ny\",true,false,null],\"b\":{\"c\":{},\"d\":[]},"
+    "\"e\":1e+300,\"f\":-0.0,\"g\":\"\"}";
+
+compact_json parse(const std::string& str) {
+    compact_json j;
+    EXPECT_TRUE(j.parse(str)) << str;
+    return j;
+}
+
+double boxed_number(double v) {
+    storage s;
+    json_value value(v);
+    s.set(value_t::number, value);
+    EXPECT_EQ(value_t::number, s.type());
+    return s.value().number;
+}
+} // namespace
+
+TEST(compact_json, size) {
+#if UINTPTR_MAX == 0xFFFFFFFFFFFFFFFFu
+    EXPECT_EQ(8u, sizeof(compact_json));
+#endif
+    EXPECT_LT(sizeof(compact_json), sizeof(microlife::json));
+}
+
+TEST(compact_json, storage) {
+    storage s;
+    EXPECT_EQ(value_t::null, s.type());
+
+    s.set(value_t::boolean, true);
+    EXPECT_EQ(value_t::boolean, s.type());
+    EXPECT_TRUE(s.value().boolean);
+    s.set(value_t::boolean, false);
+    EXPECT_FALSE(s.value().boolean);
+
+    std::string str = "boxed";
+    json_value value;
+    value.string = &str;
+    s.set(value_t::string, value);
+    EXPECT_EQ(value_t::string, s.type());
+    EXPECT_EQ(&str, s.value().string);
+
+    // every double is a number, whatever its bits
+    const double numbers[] = {0.0,
+                              -0.0,
+                              1.0,
+                              -1.5,
+                              std::numeric_limits<double>::max(),
+                              std::numeric_limits<double>::lowest(),
+                              std::numeric_limits<double>::min(),
+                              std::numeric_limits<double>::denorm_min(),
+                              std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity()};
+    for (double d : numbers) {
+        double boxed = boxed_number(d);
+        EXPECT_EQ(d, boxed);
+        EXPECT_EQ(std::signbit(d), std::signbit(boxed));
+    }
+
+    // NaN (of any sign) is canonicalized and stays a number
+    EXPECT_TRUE(std::isnan(boxed_number(std::nan(""))));
+    EXPECT_TRUE(std::isnan(boxed_number(-std::nan(""))));
+}
+
+TEST(compact_json, value) {
+    EXPECT_TRUE(compact_json().is_null());
+    EXPECT_TRUE(compact_json(true).get<bool>());
+    EXPECT_FALSE(compact_json(false).get<bool>());
+    EXPECT_EQ(-3, compact_json(-3).get<int>());
+    EXPECT_EQ(0.25, compact_json(0.25).get<double>());
+    EXPECT_EQ("str", compact_json("str").get<std::string>());
+    EXPECT_TRUE(compact_json(value_t::array).is_array());
+    EXPECT_TRUE(compact_json(value_t::object).is_object());
+
+    compact_json nan(std::nan(""));
+    EXPECT_TRUE(nan.is_number());
+    EXPECT_EQ("null", nan.dump());
+}
+
+TEST(compact_json, parse) {
+    auto j = parse(text);
+    microlife::json plain;
+    ASSERT_TRUE(plain.parse(text));
+    EXPECT_EQ(plain.dump(), j.dump());
+
+    auto& a = j.get<compact_json::object_t&>()["a"];
+    ASSERT_TRUE(a.is_array());
+    auto& array = a.get<compact_json::array_t&>();
+    ASSERT_EQ(6u, array.size());
+    EXPECT_EQ(-2.5, array[1].get<double>());
+    EXPECT_EQ("x\ny", array[2].get<std::string>());
+    EXPECT_TRUE(array[3].get<bool>());
+    EXPECT_TRUE(array[5].is_null());
+}
+
+TEST(compact_json, copy_and_move) {
+    auto j1 = parse(text);
+    compact_json j2 = j1;
+    EXPECT_TRUE(j1 == j2);
+    EXPECT_EQ(j1.dump(), j2.dump());
+
+    compact_json j3 = std::move(j2);
+    EXPECT_TRUE(j2.is_null());
+    EXPECT_TRUE(j1 == j3);
+
+    j2 = j3;
+    j3 = compact_json(1);
+    EXPECT_TRUE(j1 == j2);
+    EXPECT_EQ(1, j3.get<int>());
+}
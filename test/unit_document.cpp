@@ -0,0 +1,334 @@
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>   // isinf
+#include <cstdint> // uint64_t, UINT64_MAX
+#include <list>    // list
+#include <memory>  // make_shared
+#include <sstream> // ostringstream
+#include <thread>  // thread
+#include <vector>  // vector
+
+using document = microlife::document;
+using json = microlife::json;
+using value_t = microlife::detail::value_t;
+
+TEST(document, read) {
+    document doc;
+    ASSERT_TRUE(doc.parse(R"({"name":"microlife","tags":["a","b"],"n":1.5,)"
+                          R"("ok":true,"none":null,"empty":{}})"));
+
+    const auto& root = doc.root();
+    EXPECT_TRUE(root.is_object());
+    EXPECT_EQ(6u, root.size());
+
+    EXPECT_EQ("microlife", root["name"].get<std::string>());
+    EXPECT_EQ("microlife", root["name"].get<std::string_view>());
+    EXPECT_STREQ("microlife", root["name"].get<const char*>());
+    EXPECT_EQ(1.5, root["n"].get<double>());
+    EXPECT_EQ(1, root["n"].get<int>());
+    EXPECT_TRUE(root["ok"].get<bool>());
+    EXPECT_TRUE(root["none"].is_null());
+    EXPECT_TRUE(root["empty"].is_object());
+    EXPECT_TRUE(root["empty"].empty());
+
+    const auto& tags = root["tags"];
+    ASSERT_TRUE(tags.is_array());
+    ASSERT_EQ(2u, tags.size());
+    EXPECT_EQ("a", tags[0].get<std::string_view>());
+    EXPECT_EQ("b", tags[1].get<std::string_view>());
+
+    std::string joined;
+    for (const auto& t : tags.elements())
+        joined += t.get<std::string>();
+    EXPECT_EQ("ab", joined);
+
+    // members keep the source order
+    std::string keys;
+    for (const auto& m : root.items())
+        keys += std::string(m.key_view()) + ",";
+    EXPECT_EQ("name,tags,n,ok,none,empty,", keys);
+
+    EXPECT_TRUE(root.contains("tags"));
+    EXPECT_FALSE(root.contains("missing"));
+    EXPECT_EQ(nullptr, root.find("missing"));
+    EXPECT_EQ(nullptr, tags.find("a"));
+}
+
+TEST(document, duplicate_key) {
+    document doc;
+    ASSERT_TRUE(doc.parse(R"({"a":1,"a":2})"));
+    EXPECT_EQ(2, doc.root()["a"].get<int>());
+}
+
+TEST(document, dump) {
+    const char* text = R"({"b":[1,2.5,"x\ny",{}],"a":{"c":null,"d":[true,)"
+                       R"(false,[]]},"\u0001":""})";
+    document doc;
+    ASSERT_TRUE(doc.parse(text));
+    EXPECT_EQ(R"({"b":[1,2.5,"x\ny",{}],"a":{"c":null,"d":[true,false,[]]},)"
+              R"("\u0001":""})",
+              doc.dump());
+
+    std::ostringstream os;
+    os << doc.root()["b"];
+    EXPECT_EQ(R"([1,2.5,"x\ny",{}])", os.str());
+
+    // same content as basic_json
+    json j;
+    ASSERT_TRUE(j.parse(doc.dump()));
+    document again;
+    ASSERT_TRUE(again.parse(j.dump()));
+    EXPECT_EQ(doc.root(), again.root());
+    EXPECT_NE(doc.root(), again.root()["a"]);
+}
+
+TEST(document, scalar_root) {
+    document doc;
+    ASSERT_TRUE(doc.parse("\"hello\""));
+    EXPECT_EQ("hello", doc.root().get<std::string_view>());
+    ASSERT_TRUE(doc.parse(" 42 "));
+    EXPECT_EQ(42, doc.root().get<int>());
+    EXPECT_EQ("42", doc.dump());
+}
+
+TEST(document, error) {
+    document doc;
+    ASSERT_TRUE(doc.parse("[1,2,3]"));
+    EXPECT_FALSE(doc.parse("[1,2,"));
+    EXPECT_TRUE(doc.root().is_null());
+    EXPECT_EQ(0u, doc.memory_usage());
+}
+
+TEST(document, reuse) {
+    std::string text = "[";
+    for (int i = 0; i < 10000; i++)
+        text += (i ? "," : "") + std::string("{\"id\":") + std::to_string(i) +
+                ",\"name\":\"user\"}";
+    text += "]";
+
+    document doc;
+    ASSERT_TRUE(doc.parse(text));
+    std::size_t used = doc.memory_usage();
+    EXPECT_GT(used, 0u);
+    ASSERT_EQ(10000u, doc.root().size());
+    EXPECT_EQ(9999, doc.root()[9999]["id"].get<int>());
+
+    // the same document again uses the same amount of memory
+    ASSERT_TRUE(doc.parse(text));
+    EXPECT_EQ(used, doc.memory_usage());
+
+    doc.clear();
+    EXPECT_TRUE(doc.root().is_null());
+    EXPECT_EQ(0u, doc.memory_usage());
+
+    // deep nesting
+    const int depth = 10000;
+    std::string deep(depth, '[');
+    deep += std::string(depth, ']');
+    ASSERT_TRUE(doc.parse(deep));
+    EXPECT_EQ(deep, doc.dump());
+}
+
+TEST(document, node_size) {
+    EXPECT_EQ(16u, sizeof(document::node));
+}
+
+TEST(document, lazy_numbers) {
+    document::parse_options lazy;
+    lazy.lazy_numbers = true;
+
+    // the text is written back as it was read
+    const char* text = R"({"price":0.1000000000000000000000000001,)"
+                       R"("big":1E+2,"id":18446744073709551615,"neg":-0,)"
+                       R"("list":[1.50,-7,3e-400]})";
+    document doc;
+    ASSERT_TRUE(doc.parse(text, lazy));
+    EXPECT_EQ(text, doc.dump());
+
+    const auto& root = doc.root();
+    EXPECT_TRUE(root["price"].is_number());
+    EXPECT_EQ(0.1, root["price"].get<double>());
+    EXPECT_EQ(100, root["big"].get<int>());
+    EXPECT_EQ(value_t::number_unsigned, root["id"].type());
+    EXPECT_EQ(UINT64_MAX, root["id"].get<std::uint64_t>());
+    EXPECT_EQ(value_t::number, root["neg"].type());
+    EXPECT_EQ(-7, root["list"][1].get<int>());
+    EXPECT_EQ(0.0, root["list"][2].get<double>());
+    // read again from the cache, still dumped verbatim
+    EXPECT_EQ(1.5, root["list"][0].get<double>());
+    EXPECT_EQ(1.5, root["list"][0].get<double>());
+    EXPECT_EQ(text, doc.dump());
+
+    // same values as an eager parse
+    document eager;
+    ASSERT_TRUE(eager.parse(text));
+    EXPECT_EQ(eager.root(), root);
+    EXPECT_NE(eager.dump(), doc.dump());
+
+    // only the grammar is checked
+    EXPECT_FALSE(doc.parse("[01]", lazy));
+    EXPECT_FALSE(doc.parse("[1.]", lazy));
+    EXPECT_FALSE(doc.parse("[-]", lazy));
+    EXPECT_FALSE(doc.parse("[1e+]", lazy));
+    EXPECT_FALSE(eager.parse("1e400"));
+    ASSERT_TRUE(doc.parse("[1e400,-1e400]", lazy));
+    EXPECT_TRUE(std::isinf(doc.root()[0].get<double>()));
+    EXPECT_GT(0.0, doc.root()[1].get<double>());
+
+    // an input read character by character
+    std::string str = "[12.50,{\"a\":-3}]";
+    std::list<char> chars(str.begin(), str.end());
+    ASSERT_TRUE(doc.parse(chars.begin(), chars.end(), lazy));
+    EXPECT_EQ(str, doc.dump());
+    EXPECT_EQ(-3, doc.root()[1]["a"].get<int>());
+
+    // the next parse without the option converts again
+    ASSERT_TRUE(doc.parse("[1.50]"));
+    EXPECT_EQ("[1.5]", doc.dump());
+}
+
+TEST(document, lazy_numbers_threads) {
+    document::parse_options lazy;
+    lazy.lazy_numbers = true;
+    std::string text = "[";
+    for (int i = 0; i < 1000; i++)
+        text += (i ? "," : "") + std::to_string(i) + ".5";
+    text += "]";
+    document doc;
+    ASSERT_TRUE(doc.parse(text, lazy));
+
+    // first reads from several threads
+    double sums[4] = {};
+    std::vector<std::thread> threads;
+    for (auto& sum : sums) {
+        threads.emplace_back([&doc, &sum] {
+            for (const auto& n : doc.root().elements())
+                sum += n.get<double>();
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    for (double sum : sums)
+        EXPECT_EQ(500000.0, sum);
+}
+
+TEST(document, borrow) {
+    const std::string text = R"({"plain":"abc","esc":"a\"b\\c/\né😀",)"
+                             R"("key":[true,"",1.5],"\t":"x"})";
+    document doc;
+    ASSERT_TRUE(doc.borrow(text));
+    const auto& root = doc.root();
+
+    // no escape: a view into the input
+    auto plain = root["plain"].get<std::string_view>();
+    EXPECT_EQ("abc", plain);
+    EXPECT_EQ(text.data() + 10, plain.data());
+
+    // escapes: decoded on the first read, then stable
+    EXPECT_EQ(value_t::string, root["esc"].type());
+    EXPECT_EQ("a\"b\\c/\n\xC3\xA9\xF0\x9F\x98\x80",
+              root["esc"].get<std::string>());
+    EXPECT_EQ(13u, root["esc"].size());
+    auto esc = root["esc"].get<std::string_view>();
+    EXPECT_EQ(esc.data(), root["esc"].get<std::string_view>().data());
+    EXPECT_STREQ("a\"b\\c/\n\xC3\xA9\xF0\x9F\x98\x80",
+                 root["esc"].get<const char*>());
+
+    // keys with escapes are decoded while parsing
+    ASSERT_TRUE(root.contains("key"));
+    EXPECT_TRUE(root["key"][1].empty());
+    EXPECT_EQ("x", root["\t"].get<std::string_view>());
+
+    // the same values as a copying parse, escapes are written back as read
+    document copy;
+    ASSERT_TRUE(copy.parse(text));
+    EXPECT_EQ(copy.root(), root);
+    EXPECT_EQ(R"({"plain":"abc","esc":"a\"b\\c/\né😀",)"
+              R"("key":[true,"",1.5],"\t":"x"})",
+              doc.dump());
+
+    // with lazy numbers nothing is converted or copied but the numbers
+    document::parse_options lazy;
+    lazy.lazy_numbers = true;
+    ASSERT_TRUE(doc.borrow(text, lazy));
+    EXPECT_EQ(1.5, doc.root()["key"][2].get<double>());
+
+    // a moved or shared input is kept alive by the document
+    ASSERT_TRUE(doc.borrow(std::string(text)));
+    EXPECT_EQ("abc", doc.root()["plain"].get<std::string_view>());
+    EXPECT_EQ(copy.root(), doc.root());
+    auto shared = std::make_shared<const std::string>(text);
+    ASSERT_TRUE(doc.borrow(shared));
+    EXPECT_EQ(2, shared.use_count());
+    shared.reset();
+    EXPECT_EQ(copy.root(), doc.root());
+    doc.clear();
+
+    // the grammar is still checked
+    EXPECT_FALSE(doc.borrow(R"(["\x"])"));
+    EXPECT_FALSE(doc.borrow(R"(["\u12"])"));
+    EXPECT_FALSE(doc.borrow(R"(["\ud83d"])"));
+    EXPECT_FALSE(doc.borrow("[\"a\x01\"]"));
+    EXPECT_FALSE(doc.borrow(R"(["abc)"));
+    EXPECT_TRUE(doc.root().is_null());
+}
+
+TEST(document, borrow_threads) {
+    std::string text = "[";
+    for (int i = 0; i < 1000; i++)
+        text += (i ? "," : "") + std::string("\"\\t") + std::to_string(i) +
+                "\"";
+    text += "]";
+    document doc;
+    ASSERT_TRUE(doc.borrow(text));
+
+    // first reads from several threads
+    std::size_t sizes[4] = {};
+    std::vector<std::thread> threads;
+    for (auto& size : sizes) {
+        threads.emplace_back([&doc, &size] {
+            for (const auto& n : doc.root().elements()) {
+                auto str = n.get<std::string_view>();
+                if (str[0] == '\t')
+                    size += str.size();
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    for (std::size_t size : sizes)
+        EXPECT_EQ(3890u, size);
+}
+
+TEST(document, parse_in_situ) {
+    std::string buffer = R"({"plain":"abc","esc":"a\"b\\c\né😀",)"
+                         R"("key":[true,"",1.5]})";
+    const std::string text = buffer;
+    document doc;
+    ASSERT_TRUE(doc.parse_in_situ(&buffer[0], buffer.size()));
+    const auto& root = doc.root();
+
+    // the strings live in the buffer, null terminated
+    const char* plain = root["plain"].get<const char*>();
+    EXPECT_STREQ("abc", plain);
+    EXPECT_EQ(buffer.data() + 10, plain);
+    const char* esc = root["esc"].get<const char*>();
+    EXPECT_STREQ("a\"b\\c\n\xC3\xA9\xF0\x9F\x98\x80", esc);
+    EXPECT_EQ(12u, root["esc"].size());
+    EXPECT_TRUE(esc > buffer.data() && esc < buffer.data() + buffer.size());
+    EXPECT_TRUE(root["key"][1].empty());
+    EXPECT_STREQ("", root["key"][1].get<const char*>());
+
+    // nothing but the nodes in the arena
+    document copy;
+    ASSERT_TRUE(copy.parse(text));
+    EXPECT_EQ(copy.root(), root);
+    EXPECT_EQ(copy.dump(), doc.dump());
+    EXPECT_LT(doc.memory_usage(), copy.memory_usage());
+
+    std::string bad = R"(["ok","\x"])";
+    EXPECT_FALSE(doc.parse_in_situ(&bad[0], bad.size()));
+    EXPECT_TRUE(doc.root().is_null());
+}
@@ -0,0 +1,238 @@
+#include "microlife/detail/hybrid_object.hpp"
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <map>             // map
+#include <memory_resource> // monotonic_buffer_resource
+#include <random>          // mt19937_64
+#include <string>          // string
+
+using object = microlife::detail::hybrid_object<std::string, int>;
+using hybrid_json =
+    microlife::detail::basic_json<microlife::detail::hybrid_object_json_policy>;
+
+namespace {
+// object and expected hold the same members
+void expect_same(const object& obj,
+                 const std::map<std::string, int>& expected) {
+    ASSERT_EQ(expected.size(), obj.size());
+    for (const auto& i : expected) {
+        auto it = obj.find(i.first);
+        ASSERT_NE(obj.end(), it) << i.first;
+        EXPECT_EQ(i.first, it->first);
+        EXPECT_EQ(i.second, it->second);
+    }
+    std::size_t n = 0;
+    for (const auto& i : obj) {
+        EXPECT_EQ(1u, expected.count(i.first));
+        n++;
+    }
+    EXPECT_EQ(expected.size(), n);
+}
+} // namespace
+
+TEST(hybrid_object, small) {
+    object obj;
+    EXPECT_TRUE(obj.empty());
+    EXPECT_EQ(obj.end(), obj.find("a"));
+
+    obj["b"] = 2;
+    obj["a"] = 1;
+    EXPECT_TRUE(obj.emplace("c", 3).second);
+    EXPECT_FALSE(obj.emplace("a", 10).second);
+    EXPECT_EQ(1, obj.at("a"));
+    EXPECT_TRUE(obj.contains("c"));
+    EXPECT_EQ(0u, obj.count("d"));
+
+    // insertion order
+    std::string keys;
+    for (const auto& i : obj)
+        keys += i.first;
+    EXPECT_EQ("bac", keys);
+
+    // the last member moves into the hole
+    EXPECT_EQ(1u, obj.erase("b"));
+    EXPECT_EQ(0u, obj.erase("b"));
+    keys.clear();
+    for (const auto& i : obj)
+        keys += i.first;
+    EXPECT_EQ("ca", keys);
+
+    object other = {{"a", 1}, {"c", 3}};
+    EXPECT_TRUE(obj == other);
+    other["c"] = 4;
+    EXPECT_TRUE(obj != other);
+}
+
+TEST(hybrid_object, large) {
+    object obj;
+    std::map<std::string, int> expected;
+    for (int i = 0; i < 10000; i++) {
+        auto key = "key" + std::to_string(i);
+        obj[key] = i;
+        expected[key] = i;
+        if (i == int(object::linear_limit) || i == 100)
+            expect_same(obj, expected);
+    }
+    expect_same(obj, expected);
+
+    // erase while iterating
+    for (auto it = obj.begin(); it != obj.end();) {
+        if (it->second % 3 == 0) {
+            expected.erase(it->first);
+            it = obj.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    expect_same(obj, expected);
+}
+
+TEST(hybrid_object, random) {
+    std::mt19937_64 rng(2026);
+    object obj;
+    std::map<std::string, int> expected;
+    for (int i = 0; i < 50000; i++) {
+        auto key = std::to_string(rng() % 300);
+        switch (rng() % 4) {
+        case 0:
+            EXPECT_EQ(expected.erase(key), obj.erase(key));
+            break;
+        case 1:
+            EXPECT_EQ(expected.count(key) != 0, obj.contains(key));
+            break;
+        default:
+            obj[key] = i;
+            expected[key] = i;
+            break;
+        }
+    }
+    expect_same(obj, expected);
+
+    obj.clear();
+    EXPECT_TRUE(obj.empty());
+    EXPECT_EQ(obj.end(), obj.find("1"));
+}
+
+TEST(hybrid_object, allocator) {
+    using pmr_object =
+        microlife::detail::hybrid_object<std::pmr::string, std::pmr::string,
+                                         std::pmr::polymorphic_allocator<
+                                             std::pair<std::pmr::string,
+                                                       std::pmr::string>>>;
+    std::pmr::monotonic_buffer_resource resource;
+    pmr_object obj(&resource);
+    for (int i = 0; i < 100; i++) {
+        obj[std::pmr::string("a long key, not a small string " +
+                             std::to_string(i))] =
+            "a long value, not a small string";
+    }
+    for (const auto& i : obj) {
+        EXPECT_EQ(&resource, i.first.get_allocator().resource());
+        EXPECT_EQ(&resource, i.second.get_allocator().resource());
+    }
+    pmr_object copy(obj, &resource);
+    EXPECT_TRUE(copy == obj);
+}
+
+TEST(hybrid_object, json) {
+    // members keep the order of the input
+    const char* const text = "{\"b\":1,\"a\":[true,{\"z\":null,\"y\":\"s\"}]}";
+    hybrid_json j;
+    ASSERT_TRUE(j.parse(text));
+    EXPECT_EQ(text, j.dump());
+
+    // equality does not depend on the order
+    hybrid_json k;
+    ASSERT_TRUE(k.parse("{\"a\":[true,{\"y\":\"s\",\"z\":null}],\"b\":1}"));
+    EXPECT_TRUE(j == k);
+    ASSERT_TRUE(k.parse("{\"a\":[true,{\"y\":\"s\",\"x\":null}],\"b\":1}"));
+    EXPECT_FALSE(j == k);
+
+    // duplicated keys keep the last value
+    ASSERT_TRUE(j.parse("{\"a\":1,\"a\":2}"));
+    EXPECT_EQ("{\"a\":2}", j.dump());
+
+    // a large object
+    std::string large = "{";
+    for (int i = 0; i < 5000; i++)
+        large += (i ? ",\"k" : "\"k") + std::to_string(i) + "\":" +
+                 std::to_string(i);
+    large += "}";
+    ASSERT_TRUE(j.parse(large));
+    EXPECT_EQ(large, j.dump());
+    EXPECT_EQ(4321, j.get<hybrid_json::object_t&>().at("k4321").get<int>());
+
+    hybrid_json copy = j;
+    EXPECT_TRUE(copy == j);
+}
+
+TEST(ordered_object, erase) {
+    using ordered = microlife::detail::ordered_object<std::string, int>;
+    for (int size : {5, 100}) {
+        ordered obj;
+        std::vector<std::string> expected;
+        for (int i = 0; i < size; i++) {
+            auto key = "k" + std::to_string((i * 37) % size);
+            obj[key] = i;
+            expected.push_back(key);
+        }
+        // erase every other member, the others keep their order
+        for (std::size_t i = 0; i < expected.size(); i += 2) {
+            EXPECT_EQ(1u, obj.erase(expected[i]));
+            expected.erase(expected.begin() + i);
+        }
+        std::vector<std::string> keys;
+        for (const auto& i : obj)
+            keys.push_back(i.first);
+        EXPECT_EQ(expected, keys);
+
+        // lookups still work after the positions moved
+        for (const auto& key : expected)
+            EXPECT_TRUE(obj.contains(key)) << key;
+        obj["new"] = -1;
+        EXPECT_EQ("new", (obj.end() - 1)->first);
+    }
+}
+
+TEST(ordered_json, round_trip) {
+    const char* const texts[] = {
+        "{\"z\":1,\"y\":2,\"x\":3}",
+        "{\"type\":\"event\",\"id\":\"e1\",\"payload\":{\"user\":\"u1\","
+        "\"action\":\"login\",\"at\":1700000000},\"sig\":\"abc\"}",
+        "[{\"b\":[],\"a\":{}},{\"a\":null,\"b\":true}]"};
+    for (const char* text : texts) {
+        microlife::ordered_json j;
+        ASSERT_TRUE(j.parse(text));
+        EXPECT_EQ(text, j.dump());
+    }
+
+    microlife::ordered_json j;
+    ASSERT_TRUE(j.parse("{\"c\":1,\"b\":2,\"a\":3}"));
+    auto& object = j.get<microlife::ordered_json::object_t&>();
+    object.erase("b");
+    object["d"] = 4;
+    EXPECT_EQ("{\"c\":1,\"a\":3,\"d\":4}", j.dump());
+}
+
+TEST(ordered_json, compare) {
+    // different keys, or the same keys in another order: antisymmetric
+    const char* const pairs[][2] = {
+        {"{\"a\":1,\"b\":2}", "{\"a\":1,\"c\":2}"},
+        {"{\"x\":1,\"y\":2}", "{\"y\":1,\"x\":2}"},
+        {"{\"b\":1,\"a\":1}", "{\"a\":1,\"b\":1}"}};
+    for (const auto& pair : pairs) {
+        microlife::ordered_json a, b;
+        ASSERT_TRUE(a.parse(pair[0]));
+        ASSERT_TRUE(b.parse(pair[1]));
+        auto diff = microlife::ordered_json::compare(a, b);
+        EXPECT_EQ(-diff, microlife::ordered_json::compare(b, a))
+            << pair[0] << " " << pair[1];
+    }
+
+    microlife::ordered_json a, b;
+    ASSERT_TRUE(a.parse("[{\"a\":1,\"b\":2},{\"a\":1,\"c\":2},{\"c\":0}]"));
+    ASSERT_TRUE(b.parse("[{\"c\":0},{\"a\":1,\"c\":2},{\"a\":1,\"b\":2}]"));
+    EXPECT_TRUE(a == b);
+}
@@ -0,0 +1,134 @@
+#include "microlife/detail/basic_json.hpp"
+#include "microlife/detail/input_adapter.hpp"
+#include "microlife/detail/lexer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>       // array
+#include <list>        // list
+#include <sstream>     // istringstream
+#include <string_view> // string_view
+
+using basic_json = microlife::detail::basic_json<>;
+using contiguous_input_adapter = microlife::detail::contiguous_input_adapter;
+using token_t = microlife::detail::token_t;
+using microlife::detail::input_adapter;
+
+// read every character of an adapter
+template <typename InputAdapterType>
+std::string read_all(InputAdapterType a) {
+    std::string ret;
+    for (char ch = a.get_character(); ch != '\0'; ch = a.get_character())
+        ret.push_back(ch);
+    return ret;
+}
+
+TEST(input_adapter, contiguous) {
+    const char* cstr = "[1,2]";
+    std::string str = "[1,2]";
+    std::string_view view = str;
+    std::vector<char> vec(str.begin(), str.end());
+    std::vector<unsigned char> uvec(str.begin(), str.end());
+    std::array<char, 5> arr = {'[', '1', ',', '2', ']'};
+
+    // every contiguous input compiles down to a raw pointer
+    static_assert(std::is_same_v<decltype(input_adapter(cstr)),
+                                 contiguous_input_adapter>);
+    static_assert(std::is_same_v<decltype(input_adapter(str)),
+                                 contiguous_input_adapter>);
+    static_assert(std::is_same_v<decltype(input_adapter(view)),
+                                 contiguous_input_adapter>);
+    static_assert(std::is_same_v<decltype(input_adapter(vec)),
+                                 contiguous_input_adapter>);
+    static_assert(std::is_same_v<decltype(input_adapter(uvec)),
+                                 contiguous_input_adapter>);
+    static_assert(std::is_same_v<decltype(input_adapter(arr)),
+                                 contiguous_input_adapter>);
+    static_assert(std::is_same_v<decltype(input_adapter(str.begin(),
+                                                        str.end())),
+                                 contiguous_input_adapter>);
+
+    EXPECT_EQ("[1,2]", read_all(input_adapter(cstr)));
+    EXPECT_EQ("[1", read_all(input_adapter(cstr, 2)));
+    EXPECT_EQ("[1,2]", read_all(input_adapter(str)));
+    EXPECT_EQ("[1,2]", read_all(input_adapter(view)));
+    EXPECT_EQ("[1,2]", read_all(input_adapter(vec)));
+    EXPECT_EQ("[1,2]", read_all(input_adapter(uvec)));
+    EXPECT_EQ("[1,2]", read_all(input_adapter(arr)));
+    EXPECT_EQ(",2", read_all(input_adapter(str.begin() + 2, str.end() - 1)));
+    EXPECT_EQ("", read_all(input_adapter(str.end(), str.end())));
+
+    // no copy: the adapter points into the input
+    EXPECT_EQ(str.data(), input_adapter(str).position());
+    EXPECT_EQ(vec.data(), input_adapter(vec).position());
+}
+
+TEST(input_adapter, iterator) {
+    std::list<char> list = {'[', 't', 'r', 'u', 'e', ']'};
+    auto a = input_adapter(list.begin(), list.end());
+    static_assert(!std::is_same_v<decltype(a), contiguous_input_adapter>);
+    EXPECT_EQ("[true]", read_all(a));
+
+    std::istringstream is("{\"a\":1}");
+    EXPECT_EQ("{\"a\":1}",
+              read_all(input_adapter(std::istreambuf_iterator<char>(is),
+                                     std::istreambuf_iterator<char>())));
+}
+
+TEST(input_adapter, lexer) {
+    std::list<char> list;
+    for (char ch : std::string(" [ -1.5e2, \"ab\\n\" ] "))
+        list.push_back(ch);
+
+    using lexer = microlife::detail::lexer<
+        basic_json, microlife::detail::iterator_input_adapter<
+                        std::list<char>::const_iterator>>;
+    lexer lex(input_adapter(list.cbegin(), list.cend()));
+    EXPECT_EQ(token_t::begin_array, lex.scan());
+    EXPECT_EQ(token_t::value_number, lex.scan());
+    EXPECT_EQ(-150, lex.get_number());
+    EXPECT_EQ(token_t::value_separator, lex.scan());
+    EXPECT_EQ(token_t::value_string, lex.scan());
+    EXPECT_EQ("ab\n", lex.get_string());
+    EXPECT_EQ(token_t::end_array, lex.scan());
+    EXPECT_EQ(token_t::end_of_input, lex.scan());
+}
+
+TEST(input_adapter, parse) {
+    const basic_json expected = basic_json::array_t({1, "x", nullptr});
+    const std::string str = "[1,\"x\",null]";
+    basic_json j;
+
+    EXPECT_TRUE(j.parse(str.c_str()));
+    EXPECT_EQ(expected, j);
+
+    j = nullptr;
+    EXPECT_TRUE(j.parse(std::string_view(str)));
+    EXPECT_EQ(expected, j);
+
+    // only the first len characters are parsed
+    j = nullptr;
+    std::string longer = str + "garbage";
+    EXPECT_TRUE(j.parse(longer.data(), str.size()));
+    EXPECT_EQ(expected, j);
+    EXPECT_FALSE(j.parse(longer.data(), str.size() - 1));
+
+    j = nullptr;
+    EXPECT_TRUE(j.parse(std::vector<char>(str.begin(), str.end())));
+    EXPECT_EQ(expected, j);
+
+    j = nullptr;
+    EXPECT_TRUE(j.parse(str.begin(), str.end()));
+    EXPECT_EQ(expected, j);
+
+    j = nullptr;
+    std::list<char> list(str.begin(), str.end());
+    EXPECT_TRUE(j.parse(list.begin(), list.end()));
+    EXPECT_EQ(expected, j);
+
+    j = nullptr;
+    std::istringstream is(str);
+    EXPECT_TRUE(j.parse(std::istreambuf_iterator<char>(is),
+                        std::istreambuf_iterator<char>()));
+    EXPECT_EQ(expected, j);
+}
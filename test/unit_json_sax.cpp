@@ -0,0 +1,118 @@
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept> // runtime_error
+
+using json = microlife::json;
+
+namespace {
+// records every event as text
+class sax_recorder : public microlife::json_sax {
+public:
+    std::string events;
+    int stop_after = -1; // return false after n events
+
+    bool null() override { return add("null"); }
+    bool boolean(bool val) override { return add(val ? "true" : "false"); }
+    bool number(double val) override {
+        return add("number(" + std::to_string(int(val)) + ")");
+    }
+    bool string(std::string& val) override {
+        return add("string(" + val + ")");
+    }
+    bool start_object() override { return add("{"); }
+    bool key(std::string& val) override { return add("key(" + val + ")"); }
+    bool end_object() override { return add("}"); }
+    bool start_array() override { return add("["); }
+    bool end_array() override { return add("]"); }
+
+private:
+    bool add(const std::string& event) {
+        if (!events.empty())
+            events += ' ';
+        events += event;
+        return stop_after < 0 || --stop_after > 0;
+    }
+};
+
+// sums every number without json_sax, only the member functions are needed
+struct sax_sum {
+    double sum = 0;
+    int keys = 0;
+
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool number(double val) {
+        sum += val;
+        return true;
+    }
+    bool string(std::string&) { return true; }
+    bool start_object() { return true; }
+    bool key(std::string&) {
+        keys++;
+        return true;
+    }
+    bool end_object() { return true; }
+    bool start_array() { return true; }
+    bool end_array() { return true; }
+};
+
+// throws from number()
+struct sax_throw : sax_sum {
+    bool number(double) { throw std::runtime_error("number"); }
+};
+} // namespace
+
+#define TEST_SAX_EVENTS(_expected, _input)                                     \
+    do {                                                                       \
+        sax_recorder sax;                                                      \
+        EXPECT_TRUE(json::sax_parse(_input, &sax));                            \
+        EXPECT_EQ(_expected, sax.events);                                      \
+    } while (0)
+
+TEST(json_sax, events) {
+    TEST_SAX_EVENTS("null", "null");
+    TEST_SAX_EVENTS("true", " true ");
+    TEST_SAX_EVENTS("false", "false");
+    TEST_SAX_EVENTS("number(123)", "123");
+    TEST_SAX_EVENTS("string(abc)", "\"abc\"");
+    TEST_SAX_EVENTS("[ ]", "[]");
+    TEST_SAX_EVENTS("{ }", "{}");
+    TEST_SAX_EVENTS("[ number(1) [ null ] { } ]", "[1,[null],{}]");
+    TEST_SAX_EVENTS("{ key(a) number(1) key(b) [ true false ] }",
+                    "{\"a\":1,\"b\":[true,false]}");
+    TEST_SAX_EVENTS("{ key(a) { key(b) { } } }", "{\"a\":{\"b\":{}}}");
+}
+
+TEST(json_sax, error) {
+    sax_recorder sax;
+    EXPECT_FALSE(json::sax_parse("[1,2", &sax));
+    EXPECT_FALSE(json::sax_parse("{\"a\" 1}", &sax));
+    EXPECT_FALSE(json::sax_parse("[1]]", &sax));
+    EXPECT_FALSE(json::sax_parse("", &sax));
+
+    // the handler stops the parser
+    sax.events.clear();
+    sax.stop_after = 3;
+    EXPECT_FALSE(json::sax_parse("[1,2,3,4]", &sax));
+    EXPECT_EQ("[ number(1) number(2)", sax.events);
+}
+
+TEST(json_sax, handler) {
+    sax_sum sax;
+    EXPECT_TRUE(json::sax_parse(
+        "[{\"a\":1,\"b\":[2,3]},{\"a\":4,\"s\":\"x\",\"n\":null}]", &sax));
+    EXPECT_EQ(10, sax.sum);
+    EXPECT_EQ(5, sax.keys);
+}
+
+TEST(json_sax, handler_throws) {
+    // the parser goes back to the pool of this thread with open arrays,
+    // the next parse must not see them
+    sax_throw sax;
+    EXPECT_THROW(json::sax_parse("[[1]]", &sax), std::runtime_error);
+    json j;
+    EXPECT_TRUE(j.parse("true"));
+    EXPECT_EQ(json(true), j);
+}
@@ -0,0 +1,96 @@
+#include "microlife/detail/key_table.hpp"
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>      // string, to_string
+#include <string_view> // string_view
+#include <thread>      // thread
+#include <vector>      // vector
+
+using microlife::interned_json;
+using microlife::detail::interned_key;
+using microlife::detail::key_cache;
+using microlife::detail::key_table;
+
+TEST(key_table, intern) {
+    key_table table;
+    auto a = table.intern("alpha");
+    auto b = table.intern(std::string("alpha"));
+    auto c = table.intern("beta");
+    EXPECT_EQ(a.data(), b.data());
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a != c);
+    EXPECT_EQ("alpha", std::string_view(a));
+    EXPECT_EQ(2u, table.size());
+
+    auto empty = table.intern("");
+    EXPECT_EQ(0u, empty.size());
+    EXPECT_TRUE(empty == table.intern(std::string_view()));
+    auto with_null = table.intern(std::string_view("a\0b", 3));
+    EXPECT_EQ(std::string_view("a\0b", 3), std::string_view(with_null));
+    EXPECT_EQ(4u, table.size());
+
+    key_cache cache(table);
+    EXPECT_TRUE(a == cache.intern("alpha"));
+    EXPECT_TRUE(a == cache.intern("alpha"));
+    EXPECT_EQ(4u, table.size());
+}
+
+TEST(key_table, threads) {
+    key_table table;
+    const int thread_count = 4;
+    const int key_count = 2000;
+    std::vector<std::vector<interned_key>> results(thread_count);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t] {
+            key_cache cache(table);
+            for (int i = 0; i < key_count; i++)
+                results[t].push_back(cache.intern("key" + std::to_string(i)));
+        });
+    }
+    for (auto& i : threads)
+        i.join();
+
+    // every thread got the same handle for the same string
+    EXPECT_EQ(std::size_t(key_count), table.size());
+    for (int i = 0; i < key_count; i++) {
+        EXPECT_EQ("key" + std::to_string(i), std::string_view(results[0][i]));
+        for (int t = 1; t < thread_count; t++)
+            EXPECT_TRUE(results[0][i] == results[t][i]);
+    }
+}
+
+TEST(interned_json, parse) {
+    const char* const text =
+        "[{\"id\":1,\"name\":\"a\",\"tags\":{\"id\":\"x\"}},"
+        "{\"id\":2,\"name\":\"b\",\"tags\":{}}]";
+    interned_json j;
+    ASSERT_TRUE(j.parse(text));
+    EXPECT_EQ(text, j.dump());
+
+    // the same key of two objects is the same string
+    auto& first = j[0].get<interned_json::object_t&>();
+    auto& second = j[1].get<interned_json::object_t&>();
+    EXPECT_EQ(first.begin()->first.data(), second.begin()->first.data());
+    EXPECT_EQ(first.begin()->first.data(),
+              first.at("tags").get<interned_json::object_t&>()
+                  .begin()->first.data());
+
+    // lookups by string and by handle
+    EXPECT_EQ(2, j[1]["id"].get<int>());
+    EXPECT_TRUE(second.contains(interned_key("name")));
+    EXPECT_FALSE(second.contains(interned_key("missing")));
+    j[1]["added"] = true;
+    EXPECT_TRUE(second.contains("added"));
+
+    interned_json copy = j;
+    EXPECT_TRUE(copy == j);
+
+    // the parser caches its keys, a second document reuses them
+    interned_json k;
+    ASSERT_TRUE(k.parse(text));
+    EXPECT_EQ(first.begin()->first.data(),
+              k[0].get<interned_json::object_t&>().begin()->first.data());
+}
@@ -3,7 +3,9 @@
 
 #include <gtest/gtest.h>
 
-using basic_json = microlife::detail::basic_json;
+#include <list> // list
+
+using basic_json = microlife::detail::basic_json<>;
 using lexer = microlife::detail::lexer<basic_json>;
 using token_t = microlife::detail::token_t;
 
@@ -126,6 +128,39 @@ TEST(lexer, string) {
     TEST_LEXER_ERROR("\"\\uD800\\uE000\"");
 }
 
+// strings longer than one vector, an escape at every position
+TEST(lexer, long_string) {
+    const std::pair<const char*, const char*> escapes[] = {
+        {"\\n", "\n"}, {"\\\"", "\""}, {"\\u20AC", "\xE2\x82\xAC"}};
+    for (const auto& e : escapes) {
+        for (std::size_t pos = 0; pos <= 70; pos++) {
+            std::string text(70, 'a');
+            std::string value = text;
+            text.insert(pos, e.first);
+            value.insert(pos, e.second);
+            TEST_LEXER_STRING(value, "\"" + text + "\"");
+
+            // non-contiguous input takes the byte by byte path
+            std::list<char> list;
+            for (char ch : "\"" + text + "\"")
+                list.push_back(ch);
+            microlife::detail::lexer<
+                basic_json, microlife::detail::iterator_input_adapter<
+                                std::list<char>::iterator>>
+                list_lex(microlife::detail::input_adapter(list.begin(),
+                                                          list.end()));
+            EXPECT_EQ(token_t::value_string, list_lex.scan());
+            EXPECT_EQ(value, list_lex.get_string());
+        }
+    }
+
+    // a control character or the end of input after a long clean run
+    for (std::size_t len = 0; len <= 70; len++) {
+        TEST_LEXER_ERROR("\"" + std::string(len, 'a') + "\x01\"");
+        TEST_LEXER_ERROR("\"" + std::string(len, 'a'));
+    }
+}
+
 // test number
 #define TEST_LEXER_NUMBER(value, json)                                         \
     do {                                                                       \
@@ -192,6 +227,81 @@ TEST(lexer, number) {
     TEST_LEXER_ERROR("-1e309");
 }
 
+// raw_numbers(): the text of the number, nothing is converted
+TEST(lexer, number_text) {
+    lexer lex;
+    lex.raw_numbers(true);
+    std::string str = "-0.50 1E+400 0 12345678901234567890123 7";
+    lex.init(str.begin(), str.end());
+    for (const char* text :
+         {"-0.50", "1E+400", "0", "12345678901234567890123", "7"}) {
+        EXPECT_EQ(token_t::value_number, lex.scan());
+        EXPECT_EQ(text, lex.get_number_text());
+    }
+    EXPECT_EQ(token_t::end_of_input, lex.scan());
+
+    for (std::string error : {"-", "1.", "1.e2", "1e", "1e+", "-a"}) {
+        lex.init(error.begin(), error.end());
+        EXPECT_EQ(token_t::parse_error, lex.scan()) << error;
+    }
+
+    // non-contiguous input keeps the text in the buffer
+    std::list<char> list = {'1', '.', '2', '5', ','};
+    microlife::detail::lexer<basic_json,
+                             microlife::detail::iterator_input_adapter<
+                                 std::list<char>::iterator>>
+        list_lex(microlife::detail::input_adapter(list.begin(), list.end()));
+    list_lex.raw_numbers(true);
+    EXPECT_EQ(token_t::value_number, list_lex.scan());
+    EXPECT_EQ("1.25", list_lex.get_number_text());
+}
+
+// raw_strings(): the text between the quotes, escapes are only validated
+TEST(lexer, string_text) {
+    lexer lex;
+    lex.raw_strings(true);
+    std::string str = R"("abc" "" "a\nb\u00e9\ud83d\ude00" "x")";
+    lex.init(str.begin(), str.end());
+
+    EXPECT_EQ(token_t::value_string, lex.scan());
+    EXPECT_EQ("abc", lex.get_string_text());
+    EXPECT_EQ(str.data() + 1, lex.get_string_text().data());
+    EXPECT_FALSE(lex.string_escaped());
+
+    EXPECT_EQ(token_t::value_string, lex.scan());
+    EXPECT_EQ("", lex.get_string_text());
+
+    EXPECT_EQ(token_t::value_string, lex.scan());
+    auto text = lex.get_string_text();
+    EXPECT_EQ(R"(a\nb\u00e9\ud83d\ude00)", text);
+    EXPECT_TRUE(lex.string_escaped());
+
+    // decoded like a copying scan, in place as well
+    std::string decoded(text.size(), ' ');
+    decoded.resize(std::size_t(
+        lexer::unescape(text.data(), text.data() + text.size(),
+                        &decoded[0]) -
+        decoded.data()));
+    EXPECT_EQ("a\nb\xC3\xA9\xF0\x9F\x98\x80", decoded);
+    std::string in_place(text);
+    in_place.resize(std::size_t(
+        lexer::unescape(in_place.data(), in_place.data() + in_place.size(),
+                        &in_place[0]) -
+        in_place.data()));
+    EXPECT_EQ(decoded, in_place);
+
+    EXPECT_EQ(token_t::value_string, lex.scan());
+    EXPECT_FALSE(lex.string_escaped());
+    EXPECT_EQ(token_t::end_of_input, lex.scan());
+
+    for (std::string error :
+         {R"("\a")", R"("\u12x4")", R"("\ud83d")", R"("\ud83d\u0041")",
+          "\"a\x01\"", "\"abc"}) {
+        lex.init(error.begin(), error.end());
+        EXPECT_EQ(token_t::parse_error, lex.scan()) << error;
+    }
+}
+
 // test other
 TEST(lexer, other) {
     TEST_LEXER_TYPE(" [ ", begin_array);
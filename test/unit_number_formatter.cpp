@@ -0,0 +1,145 @@
+#include "microlife/detail/number_formatter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>   // nan
+#include <cstdio>  // snprintf
+#include <cstdlib> // strtod
+#include <cstring> // memcpy
+#include <limits>  // numeric_limits
+#include <random>  // mt19937_64
+#include <string>  // string
+
+using number_formatter = microlife::detail::number_formatter;
+
+namespace {
+std::string format(double value) {
+    char buffer[number_formatter::buffer_size];
+    auto end = number_formatter::format_double(buffer, value);
+    EXPECT_LE(end - buffer, number_formatter::buffer_size);
+    return std::string(buffer, end);
+}
+
+// number of significant digits of a "%g" / "%e" style text
+int significant_digits(const std::string& str) {
+    std::string digits;
+    for (char ch : str) {
+        if (ch == 'e')
+            break;
+        if (ch >= '0' && ch <= '9' && (ch != '0' || !digits.empty()))
+            digits.push_back(ch);
+    }
+    // trailing zeros of an integer are not significant
+    while (!digits.empty() && digits.back() == '0')
+        digits.pop_back();
+    return int(digits.size());
+}
+
+// format() must parse back to the same bits with as few digits as possible
+void expect_shortest(double value) {
+    auto str = format(value);
+
+    double actual = strtod(str.c_str(), nullptr);
+    ASSERT_EQ(0, memcmp(&value, &actual, sizeof(double))) << str;
+
+    // the first precision that round-trips through printf
+    char buffer[64];
+    int precision = 1;
+    for (; precision < 17; precision++) {
+        snprintf(buffer, sizeof(buffer), "%.*e", precision - 1, value);
+        if (strtod(buffer, nullptr) == value)
+            break;
+    }
+    EXPECT_LE(significant_digits(str), precision) << str << " " << buffer;
+}
+} // namespace
+
+TEST(number_formatter, layout) {
+    EXPECT_EQ("0", format(0.0));
+    EXPECT_EQ("-0", format(-0.0));
+    EXPECT_EQ("1", format(1.0));
+    EXPECT_EQ("-123", format(-123.0));
+    EXPECT_EQ("9007199254740991", format(9007199254740991.0));
+    EXPECT_EQ("9007199254740992", format(9007199254740992.0));
+    EXPECT_EQ("0.5", format(0.5));
+    EXPECT_EQ("0.1", format(0.1));
+    EXPECT_EQ("0.30000000000000004", format(0.1 + 0.2));
+    EXPECT_EQ("123.456", format(123.456));
+    EXPECT_EQ("0.0001", format(1e-4));
+    EXPECT_EQ("1e-05", format(1e-5));
+    EXPECT_EQ("1.5e-07", format(1.5e-7));
+    EXPECT_EQ("10000000000000000", format(1e16));
+    EXPECT_EQ("1e+17", format(1e17));
+    EXPECT_EQ("1.2345678901234568e+17", format(123456789012345678.0));
+    EXPECT_EQ("1e+100", format(1e100));
+    EXPECT_EQ("5e-324", format(std::numeric_limits<double>::denorm_min()));
+    EXPECT_EQ("2.2250738585072014e-308",
+              format(std::numeric_limits<double>::min()));
+    EXPECT_EQ("1.7976931348623157e+308",
+              format(std::numeric_limits<double>::max()));
+    EXPECT_EQ("-1.7976931348623157e+308",
+              format(std::numeric_limits<double>::lowest()));
+
+    // no JSON representation
+    EXPECT_EQ("null", format(std::nan("")));
+    EXPECT_EQ("null", format(std::numeric_limits<double>::infinity()));
+    EXPECT_EQ("null", format(-std::numeric_limits<double>::infinity()));
+}
+
+TEST(number_formatter, integer) {
+    char buffer[32];
+    auto to_string = [&](std::uint64_t v) {
+        return std::string(buffer,
+                           number_formatter::format_integer(buffer, v));
+    };
+    EXPECT_EQ("0", to_string(0));
+    EXPECT_EQ("7", to_string(7));
+    EXPECT_EQ("10", to_string(10));
+    EXPECT_EQ("99", to_string(99));
+    EXPECT_EQ("100", to_string(100));
+    EXPECT_EQ("18446744073709551615", to_string(UINT64_MAX));
+
+    // around every power of ten
+    std::uint64_t power = 1;
+    for (int i = 1; i < 20; i++) {
+        power *= 10;
+        EXPECT_EQ(std::to_string(power - 1), to_string(power - 1));
+        EXPECT_EQ(std::to_string(power), to_string(power));
+        EXPECT_EQ(i + 1, number_formatter::count_digits(power));
+    }
+
+    auto to_signed = [&](std::int64_t v) {
+        return std::string(buffer,
+                           number_formatter::format_signed(buffer, v));
+    };
+    EXPECT_EQ("-1", to_signed(-1));
+    EXPECT_EQ("42", to_signed(42));
+    EXPECT_EQ("-9223372036854775808", to_signed(INT64_MIN));
+    EXPECT_EQ("9223372036854775807", to_signed(INT64_MAX));
+}
+
+TEST(number_formatter, shortest) {
+    // powers of two and ten, the boundaries of each binade
+    for (int e = -1074; e <= 1023; e++)
+        expect_shortest(std::ldexp(1.0, e));
+    for (int e = -323; e <= 308; e++)
+        expect_shortest(strtod(("1e" + std::to_string(e)).c_str(), nullptr));
+
+    std::mt19937_64 rng(2026);
+    for (int i = 0; i < 100000; i++) {
+        std::uint64_t bits = rng();
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (std::isfinite(value))
+            expect_shortest(value);
+    }
+
+    // short decimals
+    std::uniform_int_distribution<int> digits(0, 999999);
+    std::uniform_int_distribution<int> exponent(-30, 30);
+    for (int i = 0; i < 20000; i++) {
+        auto str = std::to_string(digits(rng)) + "e" +
+                   std::to_string(exponent(rng));
+        expect_shortest(strtod(str.c_str(), nullptr));
+    }
+}
@@ -0,0 +1,196 @@
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // int64_t, uint64_t, INT64_MIN
+#include <string>  // string, to_string
+
+using json = microlife::json;
+using value_t = json::value_t;
+
+namespace {
+template <typename Json>
+Json parse(const std::string& str) {
+    Json j;
+    EXPECT_TRUE(j.parse(str)) << str;
+    return j;
+}
+
+#define TEST_NUMBER_TYPE(_type, _input)                                        \
+    do {                                                                       \
+        auto j = parse<json>(_input);                                          \
+        EXPECT_EQ(value_t::_type, j.type()) << _input;                         \
+        EXPECT_TRUE(j.is_number()) << _input;                                  \
+    } while (0)
+
+// every integer of the text dumps back to the same text
+template <typename Json>
+void test_round_trip() {
+    const std::string ids =
+        "[0,-1,7,-42,123456789,1234567890123,140737488355327,"
+        "-140737488355328,281474976710655]";
+    auto dump = parse<Json>(ids).dump();
+    EXPECT_EQ(ids, std::string(dump.data(), dump.size()));
+}
+} // namespace
+
+TEST(number_integer, type) {
+    TEST_NUMBER_TYPE(number_integer, "0");
+    TEST_NUMBER_TYPE(number_integer, "-1");
+    TEST_NUMBER_TYPE(number_integer, "12345678");
+    TEST_NUMBER_TYPE(number_integer, "1234567890123456789");
+    TEST_NUMBER_TYPE(number_integer, "9223372036854775807");
+    TEST_NUMBER_TYPE(number_integer, "-9223372036854775808");
+    TEST_NUMBER_TYPE(number_unsigned, "9223372036854775808");
+    TEST_NUMBER_TYPE(number_unsigned, "18446744073709551615");
+
+    // a fraction, an exponent, -0 or too large for 64 bits: a double
+    TEST_NUMBER_TYPE(number, "1.0");
+    TEST_NUMBER_TYPE(number, "1e2");
+    TEST_NUMBER_TYPE(number, "-0");
+    TEST_NUMBER_TYPE(number, "-9223372036854775809");
+    TEST_NUMBER_TYPE(number, "18446744073709551616");
+    TEST_NUMBER_TYPE(number, "123456789012345678901");
+
+    EXPECT_EQ("-0", parse<json>("-0").dump());
+    EXPECT_EQ(1e20, parse<json>("100000000000000000000").get<double>());
+}
+
+TEST(number_integer, exact) {
+    // above 2^53 a double would round these
+    const char* const values[] = {
+        "9007199254740993",     "-9007199254740993",
+        "1234567890123456789",  "9223372036854775807",
+        "-9223372036854775808", "9223372036854775808",
+        "18446744073709551615", "[1152921504606846977,-2]"};
+    for (auto str : values)
+        EXPECT_EQ(str, parse<json>(str).dump());
+
+    EXPECT_EQ(INT64_MIN,
+              parse<json>("-9223372036854775808").get<std::int64_t>());
+    EXPECT_EQ(UINT64_MAX,
+              parse<json>("18446744073709551615").get<std::uint64_t>());
+    EXPECT_EQ(9007199254740993,
+              parse<json>("9007199254740993").get<std::int64_t>());
+
+    // 8 digits at a time, at every position of the input
+    std::string digits = "1";
+    for (int i = 2; i <= 19; i++) {
+        digits += char('0' + i % 10);
+        EXPECT_EQ(std::stoll(digits),
+                  parse<json>(digits).get<std::int64_t>());
+        auto array = "[" + digits + "]";
+        EXPECT_EQ(array, parse<json>(array).dump());
+        EXPECT_EQ(std::stod("0." + digits),
+                  parse<json>("0." + digits).get<double>());
+    }
+}
+
+TEST(number_integer, get) {
+    json i(-5);
+    EXPECT_EQ(value_t::number_integer, i.type());
+    EXPECT_EQ(-5, i.get<int>());
+    EXPECT_EQ(-5, i.get<std::int64_t>());
+    EXPECT_EQ(-5.0, i.get<double>());
+
+    json u(std::uint64_t(UINT64_MAX));
+    EXPECT_EQ(value_t::number_unsigned, u.type());
+    EXPECT_EQ(UINT64_MAX, u.get<std::uint64_t>());
+    EXPECT_EQ(18446744073709551615.0, u.get<double>());
+
+    // an unsigned type holding a small value is a number_integer
+    json small(7u);
+    EXPECT_EQ(value_t::number_integer, small.type());
+    EXPECT_EQ(7u, small.get<unsigned>());
+
+    // a double is truncated, like static_cast
+    EXPECT_EQ(2, json(2.75).get<int>());
+    EXPECT_EQ(3u, json(3.5).get<std::uint64_t>());
+}
+
+TEST(number_integer, compare) {
+    // the three kinds compare by value
+    EXPECT_TRUE(json(1) == json(1.0));
+    EXPECT_TRUE(parse<json>("[1,2]") == parse<json>("[1.0,2e0]"));
+    EXPECT_FALSE(json(-1) == json(std::uint64_t(UINT64_MAX)));
+    EXPECT_EQ(-1, json::compare(json(-1), json(std::uint64_t(UINT64_MAX))));
+    EXPECT_EQ(1, json::compare(json(std::uint64_t(UINT64_MAX)), json(-1)));
+    EXPECT_EQ(-1, json::compare(json(INT64_MAX),
+                                json(std::uint64_t(INT64_MAX) + 1)));
+    EXPECT_EQ(1, json::compare(json(3), json(2.5)));
+    EXPECT_EQ(-1, json::compare(json(3), json("3")));
+}
+
+TEST(number_integer, policies) {
+    test_round_trip<microlife::json>();
+    test_round_trip<microlife::compact::json>();
+    test_round_trip<microlife::sso::json>();
+    test_round_trip<microlife::pmr::json>();
+    test_round_trip<microlife::ordered_json>();
+
+    // compact: integers of up to 48 bits are in the node, larger ones are
+    // boxed and stay exact
+    using compact_json = microlife::compact::json;
+    EXPECT_EQ(value_t::number_integer,
+              parse<compact_json>("-140737488355328").type());
+    EXPECT_EQ(value_t::number_integer,
+              parse<compact_json>("140737488355328").type());
+    EXPECT_EQ(140737488355328,
+              parse<compact_json>("140737488355328").get<std::int64_t>());
+    EXPECT_EQ(-3, compact_json(-3).get<int>());
+
+    const std::string ids = "[9007199254740993,-9223372036854775808,"
+                            "18446744073709551615,281474976710656]";
+    auto j = parse<compact_json>(ids);
+    EXPECT_EQ(ids, j.dump());
+    EXPECT_EQ(value_t::number_unsigned, j[2].type());
+    EXPECT_EQ(UINT64_MAX, j[2].get<std::uint64_t>());
+    compact_json copy = j;
+    j[0] = 1;
+    EXPECT_EQ(9007199254740993, copy[0].get<std::int64_t>());
+    copy[1] = copy[0];
+    EXPECT_EQ("[9007199254740993,9007199254740993,18446744073709551615,"
+              "281474976710656]",
+              copy.dump());
+    EXPECT_TRUE(copy[0] == copy[1]);
+}
+
+TEST(number_integer, document) {
+    microlife::document doc;
+    const char* const text = "[9223372036854775807,18446744073709551615,-1,"
+                             "0.5]";
+    ASSERT_TRUE(doc.parse(text));
+    EXPECT_EQ(text, doc.dump());
+    const auto& root = doc.root();
+    EXPECT_EQ(value_t::number_integer, root[0].type());
+    EXPECT_EQ(INT64_MAX, root[0].get<std::int64_t>());
+    EXPECT_EQ(UINT64_MAX, root[1].get<std::uint64_t>());
+    EXPECT_EQ(-1, root[2].get<int>());
+    EXPECT_TRUE(root[3].is_number());
+
+    microlife::document other;
+    ASSERT_TRUE(other.parse("[9223372036854775807,18446744073709551615,-1.0,"
+                            "5e-1]"));
+    EXPECT_TRUE(other.root() == root);
+}
+
+TEST(number_integer, sax) {
+    // a handler without number_integer() gets doubles
+    struct sum_sax {
+        double sum = 0;
+        bool null() { return true; }
+        bool boolean(bool) { return true; }
+        bool number(double val) {
+            sum += val;
+            return true;
+        }
+        bool string(std::string&) { return true; }
+        bool start_object() { return true; }
+        bool key(std::string&) { return true; }
+        bool end_object() { return true; }
+        bool start_array() { return true; }
+        bool end_array() { return true; }
+    } sax;
+    EXPECT_TRUE(json::sax_parse("[1,2.5,{\"a\":3}]", &sax));
+    EXPECT_EQ(6.5, sax.sum);
+}
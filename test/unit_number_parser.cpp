@@ -0,0 +1,132 @@
+#include "microlife/detail/basic_json.hpp"
+#include "microlife/detail/lexer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib> // strtod
+#include <random>  // mt19937_64
+
+using basic_json = microlife::detail::basic_json<>;
+using lexer = microlife::detail::lexer<basic_json>;
+using token_t = microlife::detail::token_t;
+
+namespace {
+// scan str as a single number, the result must be bit-identical to strtod
+// numbers too large for a double are a parse error
+void expect_same_as_strtod(const std::string& str) {
+    lexer lex;
+    lex.init(str.begin(), str.end());
+
+    double expected = strtod(str.c_str(), nullptr);
+    if (expected - expected != 0) {
+        EXPECT_EQ(token_t::parse_error, lex.scan()) << str;
+        return;
+    }
+    ASSERT_EQ(token_t::value_number, lex.scan()) << str;
+
+    double actual = lex.get_number();
+    EXPECT_EQ(0, memcmp(&expected, &actual, sizeof(double)))
+        << str << ": " << expected << " != " << actual;
+}
+} // namespace
+
+TEST(number_parser, exact) {
+    // integers
+    expect_same_as_strtod("0");
+    expect_same_as_strtod("-0");
+    expect_same_as_strtod("9007199254740992");
+    expect_same_as_strtod("9007199254740993"); // 2^53 + 1, ties to even
+    expect_same_as_strtod("9007199254740995");
+    expect_same_as_strtod("18446744073709551615");
+    expect_same_as_strtod("18446744073709551616");
+    expect_same_as_strtod("123456789012345678901234567890");
+
+    // leading zeros of the fraction are not significant digits
+    expect_same_as_strtod("0.000000000000000000000000000012345678901234567");
+    expect_same_as_strtod("-0.0000");
+
+    // halfway cases with more than 19 digits
+    expect_same_as_strtod(
+        "1.00000000000000011102230246251565404236316680908203125");
+    expect_same_as_strtod(
+        "1.00000000000000011102230246251565404236316680908203124");
+    expect_same_as_strtod(
+        "1.00000000000000011102230246251565404236316680908203126");
+    expect_same_as_strtod(
+        "9007199254740993.0000000000000000000000000000000000001");
+    expect_same_as_strtod("0.1000000000000000055511151231257827021181583404"
+                          "541015625");
+    expect_same_as_strtod("7.2057594037927933e16");
+
+    // subnormal and limits
+    expect_same_as_strtod("2.2250738585072011e-308");
+    expect_same_as_strtod("2.2250738585072012e-308");
+    expect_same_as_strtod("4.9406564584124654e-324");
+    expect_same_as_strtod("2.4703282292062327e-324"); // rounds to 0
+    expect_same_as_strtod("2.4703282292062328e-324"); // rounds up
+    expect_same_as_strtod("1.7976931348623157e308");
+    expect_same_as_strtod("1.7976931348623158e308");
+    expect_same_as_strtod("1e-400");
+    expect_same_as_strtod("0e999999999999999999999");
+    expect_same_as_strtod("1e-99999999999999999999");
+    expect_same_as_strtod("0.0000000000000000000000000001e28");
+    expect_same_as_strtod("100000000000000000000000000000e-29");
+}
+
+TEST(number_parser, overflow) {
+    const char* inputs[] = {"1.7976931348623159e308", "2e308",
+                            "-1e99999999999999999999",
+                            "179769313486231580793728971405303415079934132710"
+                            "037826936173778980444968292764750946649017977587"
+                            "207096330286416692887910946555547851940402630657"
+                            "488671505820681908902000708383676273854845817711"
+                            "531764475730270069855571366959622842914819860834"
+                            "936475292719074168444365510704342711559699508093"
+                            "042880177904174497792"};
+    for (auto str : inputs) {
+        lexer lex;
+        std::string s = str;
+        lex.init(s.begin(), s.end());
+        EXPECT_EQ(token_t::parse_error, lex.scan()) << str;
+    }
+}
+
+TEST(number_parser, random) {
+    std::mt19937_64 rng(20261017);
+
+    // random bit patterns printed with 17 significant digits
+    char buffer[64];
+    for (int i = 0; i < 20000; i++) {
+        std::uint64_t bits = rng();
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        if (d != d || d - d != 0) // nan, inf
+            continue;
+        snprintf(buffer, sizeof(buffer), "%.17g", d);
+        expect_same_as_strtod(buffer);
+        snprintf(buffer, sizeof(buffer), "%.*e", int(rng() % 25), d);
+        expect_same_as_strtod(buffer);
+    }
+
+    // random digit strings, up to 40 significant digits
+    for (int i = 0; i < 20000; i++) {
+        std::string str;
+        if (rng() & 1)
+            str += '-';
+        int integer = int(rng() % 20);
+        str += char('1' + rng() % 9);
+        for (int k = 0; k < integer; k++)
+            str += char('0' + rng() % 10);
+        if (rng() & 1) {
+            str += '.';
+            int fraction = 1 + int(rng() % 20);
+            for (int k = 0; k < fraction; k++)
+                str += char('0' + rng() % 10);
+        }
+        if (rng() & 1) {
+            str += 'e';
+            str += std::to_string(int(rng() % 640) - 330);
+        }
+        expect_same_as_strtod(str);
+    }
+}
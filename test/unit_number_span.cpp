@@ -0,0 +1,134 @@
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // min, max
+#include <cmath>     // fabs
+#include <string>    // string, to_string
+#include <vector>    // vector
+
+using microlife::detail::number_span;
+using microlife::detail::simd;
+
+namespace {
+// the levels compiled in and supported by this CPU
+std::vector<simd::level> supported_levels() {
+    std::vector<simd::level> ret = {simd::level::scalar};
+    auto best = simd::detect();
+    if (best >= simd::level::sse2)
+        ret.push_back(simd::level::sse2);
+    if (best >= simd::level::avx2)
+        ret.push_back(simd::level::avx2);
+    return ret;
+}
+
+template <typename Json>
+void test_numbers() {
+    Json j;
+    ASSERT_TRUE(j.parse("[1.5,-2,3.25,1e3]"));
+    auto numbers = j.numbers();
+    ASSERT_TRUE(numbers.has_value());
+    ASSERT_EQ(4u, numbers->size());
+    EXPECT_EQ(1.5, (*numbers)[0]);
+    EXPECT_EQ(1000.0, numbers->back());
+    std::vector<double> copy(numbers->begin(), numbers->end());
+    EXPECT_EQ((std::vector<double>{1.5, -2, 3.25, 1000}), copy);
+    EXPECT_EQ(1002.75, numbers->sum());
+    EXPECT_EQ(-2.0, numbers->min());
+    EXPECT_EQ(1000.0, numbers->max());
+    EXPECT_EQ(1002.75 / 4, numbers->mean());
+
+    // the elements stay ordinary values
+    EXPECT_EQ(3.25, j[2].template get<double>());
+    j[2] = 4.0;
+    EXPECT_EQ(4.0, (*j.numbers())[2]);
+    j[2] = 4;
+    EXPECT_EQ(4.0, (*j.numbers())[2]);
+
+    // integers and mixed arrays are converted, across several blocks
+    std::string text = "[";
+    double sum = 0.5, min = 0.5, max = 0.5;
+    for (int i = 0; i < 1000; i++) {
+        int v = i * 37 % 1001 - 500;
+        text += (i ? "," : "") + std::to_string(v);
+        sum += v;
+        min = std::min(min, double(v));
+        max = std::max(max, double(v));
+    }
+    ASSERT_TRUE(j.parse(text + ",0.5,-0.0]"));
+    numbers = j.numbers();
+    ASSERT_TRUE(numbers.has_value());
+    EXPECT_TRUE(numbers->converting());
+    EXPECT_FALSE(numbers->contiguous());
+    ASSERT_EQ(1002u, numbers->size());
+    EXPECT_EQ(sum, numbers->sum());
+    EXPECT_EQ(min, numbers->min());
+    EXPECT_EQ(max, numbers->max());
+    EXPECT_EQ(0.5, *(numbers->end() - 2));
+    EXPECT_EQ(-500.0, numbers->front());
+
+    // above 2^53 the conversion rounds
+    ASSERT_TRUE(j.parse("[9007199254740993,18446744073709551615]"));
+    EXPECT_EQ(9007199254740992.0, j.numbers()->front());
+    EXPECT_EQ(18446744073709551616.0, j.numbers()->back());
+
+    ASSERT_TRUE(j.parse("[]"));
+    ASSERT_TRUE(j.numbers().has_value());
+    EXPECT_TRUE(j.numbers()->empty());
+    EXPECT_EQ(0.0, j.numbers()->sum());
+
+    ASSERT_TRUE(j.parse("[1,true]"));
+    EXPECT_FALSE(j.numbers().has_value());
+    ASSERT_TRUE(j.parse("{\"a\":1}"));
+    EXPECT_FALSE(j.numbers().has_value());
+}
+} // namespace
+
+TEST(number_span, json) { test_numbers<microlife::json>(); }
+TEST(number_span, compact_json) {
+    test_numbers<microlife::compact::json>();
+
+    // a compact number node is the double itself
+    microlife::compact::json j;
+    ASSERT_TRUE(j.parse("[1,2,3]"));
+    ASSERT_TRUE(j.numbers().has_value());
+    EXPECT_EQ(6.0, j.numbers()->sum());
+    ASSERT_TRUE(j.parse("[1.5,2.5,3.5]"));
+    EXPECT_TRUE(j.numbers()->contiguous());
+}
+TEST(number_span, sso_json) { test_numbers<microlife::sso::json>(); }
+TEST(number_span, pmr_json) { test_numbers<microlife::pmr::json>(); }
+
+TEST(number_span, reductions) {
+    // every length around the vector widths, contiguous and strided
+    std::vector<double> values;
+    for (int i = 0; i < 100; i++)
+        values.push_back((i * 37 % 101) * 0.5 - 20);
+    std::vector<double> strided(values.size() * 3);
+    for (std::size_t i = 0; i < values.size(); i++)
+        strided[3 * i + 1] = values[i];
+
+    for (auto l : supported_levels()) {
+        auto f = number_span::functions(l);
+        for (std::size_t n = 1; n <= values.size(); n++) {
+            double sum = 0, min = values[0], max = values[0];
+            for (std::size_t i = 0; i < n; i++) {
+                sum += values[i];
+                min = std::min(min, values[i]);
+                max = std::max(max, values[i]);
+            }
+            auto contiguous =
+                reinterpret_cast<const unsigned char*>(values.data());
+            auto every_third =
+                reinterpret_cast<const unsigned char*>(strided.data() + 1);
+            for (auto [first, stride] :
+                 {std::pair(contiguous, sizeof(double)),
+                  std::pair(every_third, 3 * sizeof(double))}) {
+                EXPECT_NEAR(sum, f.sum(first, n, stride), 1e-9)
+                    << "level " << int(l) << ", n " << n;
+                EXPECT_EQ(min, f.min(first, n, stride));
+                EXPECT_EQ(max, f.max(first, n, stride));
+            }
+        }
+    }
+}
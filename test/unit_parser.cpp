@@ -6,7 +6,7 @@
 
 #include <gtest/gtest.h>
 
-using basic_json = microlife::detail::basic_json;
+using basic_json = microlife::detail::basic_json<>;
 using parser = microlife::detail::parser<microlife::detail::lexer, basic_json>;
 
 parser m_parser;
@@ -69,7 +69,10 @@ TEST(parser, parse) {
     TEST_PARSER_PARSE_TRUE(null, "null");
     TEST_PARSER_PARSE_TRUE(boolean, "true");
     TEST_PARSER_PARSE_TRUE(boolean, "false");
-    TEST_PARSER_PARSE_TRUE(number, "123");
+    TEST_PARSER_PARSE_TRUE(number_integer, "123");
+    TEST_PARSER_PARSE_TRUE(number_unsigned, "18446744073709551615");
+    TEST_PARSER_PARSE_TRUE(number, "1.5");
+    TEST_PARSER_PARSE_TRUE(number, "1e3");
     TEST_PARSER_PARSE_TRUE(string, "\"hello\"");
 
     TEST_PARSER_PARSE_TRUE(array, "[123,true,false]");
@@ -83,3 +86,37 @@ TEST(parser, parse) {
     TEST_PARSER_PARSE_TRUE(object, "{\"v\":[{\"a\":null}]}");
     TEST_PARSER_PARSE_TRUE(object, "{\"v\":null,\"a\":null,\"b\":null}");
 }
+
+TEST(parser, in_place) {
+    basic_json j;
+
+    // elements keep the input order
+    EXPECT_TRUE(m_parser.parse("[1,\"a\",[true,null],{\"k\":[2,3]}]", j));
+    auto& a = j.get<basic_json::array_t&>();
+    ASSERT_EQ(4, a.size());
+    EXPECT_EQ(1, a[0].get<int>());
+    EXPECT_EQ("a", a[1].get<basic_json::string_t>());
+    EXPECT_TRUE(a[2].get<basic_json::array_t&>()[0].get<bool>());
+    EXPECT_TRUE(a[2].get<basic_json::array_t&>()[1].is_null());
+    auto& k = a[3].get<basic_json::object_t&>().at("k");
+    EXPECT_EQ(2, k.get<basic_json::array_t&>()[0].get<int>());
+    EXPECT_EQ(3, k.get<basic_json::array_t&>()[1].get<int>());
+
+    // a duplicated key keeps the last value
+    EXPECT_TRUE(m_parser.parse("{\"a\":1,\"b\":2,\"a\":[3]}", j));
+    EXPECT_EQ(2, j.get<basic_json::object_t&>().size());
+    EXPECT_TRUE(j.get<basic_json::object_t&>().at("a").is_array());
+
+    // a failed parse leaves the target untouched
+    EXPECT_FALSE(m_parser.parse("[1,2", j));
+    EXPECT_TRUE(j.is_object());
+
+    // deep nesting does not use the call stack of the parser
+    const int depth = 10000;
+    basic_json::string_t deep(depth, '[');
+    deep += basic_json::string_t(depth, ']');
+    EXPECT_TRUE(m_parser.parse(deep, j));
+    EXPECT_TRUE(j.is_array());
+    deep.pop_back();
+    EXPECT_FALSE(m_parser.parse(deep, j));
+}
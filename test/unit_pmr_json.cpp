@@ -0,0 +1,158 @@
+#include "microlife/detail/arena.hpp"
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory_resource> // memory_resource
+
+using pmr_json = microlife::pmr::json;
+using value_t = pmr_json::value_t;
+
+namespace {
+// counts the memory handed out through it
+class counting_resource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t outstanding = 0; // bytes not yet deallocated
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        allocations++;
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const
+        noexcept override {
+        return this == &other;
+    }
+};
+
+// every string, array and object of j uses resource
+void expect_resource(pmr_json& j, std::pmr::memory_resource* resource) {
+    EXPECT_EQ(resource, j.get_allocator().resource());
+    switch (j.type()) {
+    case value_t::string:
+        EXPECT_EQ(resource,
+                  j.get<pmr_json::string_t&>().get_allocator().resource());
+        break;
+    case value_t::array:
+        EXPECT_EQ(resource,
+                  j.get<pmr_json::array_t&>().get_allocator().resource());
+        for (auto& i : j.get<pmr_json::array_t&>())
+            expect_resource(i, resource);
+        break;
+    case value_t::object:
+        EXPECT_EQ(resource,
+                  j.get<pmr_json::object_t&>().get_allocator().resource());
+        for (auto& i : j.get<pmr_json::object_t&>()) {
+            EXPECT_EQ(resource, i.first.get_allocator().resource());
+            expect_resource(i.second, resource);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+const char* const text =
+    R"({"name":"a string longer than the small string buffer",)"
+    R"("list":[1,"two",[3,{"four":4}],{}],"nested":{"x":{"y":null}}})";
+} // namespace
+
+TEST(pmr_json, parse) {
+    counting_resource resource;
+    {
+        pmr_json j(&resource);
+        ASSERT_TRUE(j.parse(text));
+        expect_resource(j, &resource);
+        EXPECT_GT(resource.allocations, 0u);
+
+        EXPECT_EQ("a string longer than the small string buffer",
+                  j.get<pmr_json::object_t&>()["name"].get<std::string>());
+
+        microlife::json plain;
+        ASSERT_TRUE(plain.parse(text));
+        EXPECT_EQ(plain.dump(), std::string(j.dump()));
+    }
+    // everything was returned
+    EXPECT_EQ(0u, resource.outstanding);
+}
+
+TEST(pmr_json, copy_and_move) {
+    counting_resource a, b;
+    {
+        pmr_json j1(&a);
+        ASSERT_TRUE(j1.parse(text));
+
+        // copy into another resource
+        pmr_json j2(j1, &b);
+        expect_resource(j2, &b);
+        EXPECT_TRUE(j1 == j2);
+
+        // assignment keeps the resource of the target
+        pmr_json j3(&b);
+        j3 = j1;
+        expect_resource(j3, &b);
+        j3 = std::move(j1);
+        expect_resource(j3, &b);
+
+        // same resource: the value is stolen
+        std::size_t before = b.allocations;
+        pmr_json j4(std::move(j2), &b);
+        EXPECT_EQ(before, b.allocations);
+        expect_resource(j4, &b);
+        EXPECT_TRUE(j2.is_null());
+    }
+    EXPECT_EQ(0u, a.outstanding);
+    EXPECT_EQ(0u, b.outstanding);
+}
+
+TEST(pmr_json, arena) {
+    microlife::detail::arena arena;
+    pmr_json j(&arena);
+    ASSERT_TRUE(j.parse(text));
+    expect_resource(j, &arena);
+    EXPECT_GT(arena.used(), 0u);
+
+    std::pmr::monotonic_buffer_resource monotonic;
+    pmr_json k(&monotonic);
+    ASSERT_TRUE(k.parse(j.dump()));
+    expect_resource(k, &monotonic);
+    EXPECT_TRUE(j == k);
+}
+
+TEST(pmr_json, policy) {
+    // the default policy stores no allocator
+    EXPECT_LT(sizeof(microlife::json), sizeof(pmr_json));
+
+    // a pointer is not a boolean
+    counting_resource resource;
+    pmr_json j(&resource);
+    EXPECT_TRUE(j.is_null());
+}
+
+TEST(pmr_json, lookup_does_not_allocate) {
+    counting_resource resource, temporaries;
+    pmr_json j(&resource);
+    ASSERT_TRUE(j.parse(R"({"a key longer than the small string buffer":1,)"
+                        R"("another key longer than the buffer":2})"));
+
+    // temporary strings would come from the default resource
+    auto* old = std::pmr::set_default_resource(&temporaries);
+    const char* key = "a key longer than the small string buffer";
+    EXPECT_TRUE(j.contains(key));
+    EXPECT_EQ(1, j.at(key).get<int>());
+    EXPECT_EQ(2, j["another key longer than the buffer"].get<int>());
+    EXPECT_EQ(2, j.value("another key longer than the buffer", 0));
+    EXPECT_EQ(nullptr, j.find("a key longer than the small string buffer!"));
+    std::pmr::set_default_resource(old);
+
+    EXPECT_EQ(0u, temporaries.allocations);
+}
@@ -0,0 +1,130 @@
+#include "microlife/detail/basic_json.hpp"
+#include "microlife/detail/output_adapter.hpp"
+#include "microlife/detail/serializer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>  // tmpfile
+#include <sstream> // ostringstream
+
+#if defined(JSON_HAS_FD_OUTPUT)
+#include <unistd.h> // pipe
+#endif
+
+using basic_json = microlife::detail::basic_json<>;
+using buffer_output_adapter = microlife::detail::buffer_output_adapter;
+
+namespace {
+const char* const document =
+    "{\"a\":[1,2.5,\"x\\ny\"],\"b\":{\"c\":null,\"d\":[true,false]},"
+    "\"e\":[],\"f\":{}}";
+
+basic_json parse(const std::string& str) {
+    basic_json j;
+    EXPECT_TRUE(j.parse(str)) << str;
+    return j;
+}
+} // namespace
+
+TEST(serializer, string) {
+    auto j = parse(document);
+    EXPECT_EQ(document, j.dump());
+
+    // dump(string_t&) appends
+    std::string out = "prefix:";
+    j.dump(out);
+    EXPECT_EQ(std::string("prefix:") + document, out);
+}
+
+TEST(serializer, escape) {
+    // keys are escaped like strings
+    auto j = parse("{\"k\\\"\\\\\\u0001\":\"\\b\\f\\n\\r\\t\\u001f/\"}");
+    EXPECT_EQ("{\"k\\\"\\\\\\u0001\":\"\\b\\f\\n\\r\\t\\u001F/\"}", j.dump());
+
+    // UTF-8 is written as is
+    EXPECT_EQ("\"\xE4\xBD\xA0\xE5\xA5\xBD\"",
+              parse("\"\\u4F60\\u597D\"").dump());
+}
+
+TEST(serializer, stream) {
+    auto j = parse(document);
+    std::ostringstream os;
+    os << j << ' ' << j;
+    EXPECT_EQ(std::string(document) + ' ' + document, os.str());
+}
+
+TEST(serializer, file) {
+    auto j = parse(document);
+    std::FILE* f = std::tmpfile();
+    ASSERT_NE(nullptr, f);
+    j.dump(f);
+
+    std::string out(std::size_t(std::ftell(f)), '\0');
+    std::rewind(f);
+    EXPECT_EQ(out.size(), std::fread(&out[0], 1, out.size(), f));
+    std::fclose(f);
+    EXPECT_EQ(document, out);
+}
+
+#if defined(JSON_HAS_FD_OUTPUT)
+TEST(serializer, fd) {
+    // larger than the buffer of the adapter, smaller than a pipe
+    basic_json j(basic_json::value_t::array);
+    for (int i = 0; i < 3000; i++)
+        j.get<basic_json::array_t&>().push_back(i);
+    auto expected = j.dump();
+    ASSERT_GT(expected.size(), microlife::detail::fd_output_adapter::buffer_size);
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    {
+        microlife::detail::fd_output_adapter out(fds[1]);
+        j.dump_to(out);
+        out.flush();
+        EXPECT_TRUE(out.good());
+    }
+    close(fds[1]);
+
+    std::string out;
+    char buffer[1024];
+    for (ssize_t n; (n = read(fds[0], buffer, sizeof(buffer))) > 0;)
+        out.append(buffer, std::size_t(n));
+    close(fds[0]);
+    EXPECT_EQ(expected, out);
+}
+#endif
+
+TEST(serializer, buffer) {
+    auto j = parse(document);
+    const std::string expected = document;
+
+    char buffer[256];
+    EXPECT_EQ(expected.size(), j.dump(buffer, sizeof(buffer)));
+    EXPECT_EQ(expected, std::string(buffer, expected.size()));
+
+    // too small: the output is cut, the full length is still reported
+    std::memset(buffer, '#', sizeof(buffer));
+    EXPECT_EQ(expected.size(), j.dump(buffer, 10));
+    EXPECT_EQ(expected.substr(0, 10), std::string(buffer, 10));
+    EXPECT_EQ('#', buffer[10]);
+
+    buffer_output_adapter out(nullptr, 0);
+    j.dump_to(out);
+    EXPECT_TRUE(out.truncated());
+    EXPECT_EQ(expected.size(), out.size());
+}
+
+TEST(serializer, deep) {
+    // deep nesting does not use the call stack of the serializer
+    const int depth = 10000;
+    std::string deep(depth, '[');
+    deep += std::string(depth, ']');
+    EXPECT_EQ(deep, parse(deep).dump());
+
+    std::string objects;
+    for (int i = 0; i < depth; i++)
+        objects += "{\"k\":";
+    objects += "1";
+    objects += std::string(depth, '}');
+    EXPECT_EQ(objects, parse(objects).dump());
+}
@@ -0,0 +1,162 @@
+#include "microlife/detail/shaped_object.hpp"
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <map>         // map
+#include <random>      // mt19937_64
+#include <string>      // string, to_string
+#include <string_view> // string_view
+
+using microlife::shaped_json;
+using microlife::detail::interned_key;
+using microlife::detail::member_key;
+using microlife::detail::object_shape;
+using object = microlife::detail::shaped_object<int>;
+
+namespace {
+// the keys of obj, in order
+std::string keys_of(const object& obj) {
+    std::string ret;
+    for (const auto& i : obj)
+        ret += std::string_view(i.first);
+    return ret;
+}
+} // namespace
+
+TEST(shaped_object, shape) {
+    object a;
+    a["x"] = 1;
+    a["y"] = 2;
+    object b;
+    b["x"] = 3;
+    b["y"] = 4;
+    // same keys in the same order: one shape
+    EXPECT_EQ(&a.shape(), &b.shape());
+    EXPECT_TRUE(a.shape().shared());
+    EXPECT_EQ("xy", keys_of(a));
+
+    object c;
+    c["y"] = 1;
+    c["x"] = 2;
+    EXPECT_NE(&a.shape(), &c.shape());
+
+    EXPECT_EQ(2, a.at("y"));
+    EXPECT_EQ(4, b.find(interned_key("y"))->second);
+    EXPECT_EQ(b.end(), b.find("z"));
+    EXPECT_FALSE(b.emplace("x", 10).second);
+    EXPECT_EQ(3, b.at("x"));
+
+    // erase moves to the shape without the key
+    b["z"] = 5;
+    EXPECT_EQ(1u, b.erase("y"));
+    EXPECT_EQ(0u, b.erase("y"));
+    EXPECT_EQ("xz", keys_of(b));
+    object d;
+    d["x"] = 3;
+    d["z"] = 5;
+    EXPECT_EQ(&d.shape(), &b.shape());
+    EXPECT_TRUE(d == b);
+
+    // equality does not depend on the order
+    c["x"] = 1;
+    c["y"] = 2;
+    EXPECT_TRUE(a == c);
+    c["y"] = 3;
+    EXPECT_TRUE(a != c);
+
+    object copy = a;
+    EXPECT_EQ(&a.shape(), &copy.shape());
+    object moved = std::move(copy);
+    EXPECT_TRUE(copy.empty());
+    EXPECT_TRUE(moved == a);
+    moved.clear();
+    EXPECT_EQ(object_shape::empty(), &moved.shape());
+}
+
+TEST(shaped_object, member_key) {
+    std::vector<object> rows(10);
+    for (int i = 0; i < 10; i++) {
+        rows[i]["id"] = i;
+        rows[i]["value"] = i * i;
+    }
+    rows[5].erase("id");
+
+    member_key value("value");
+    member_key missing("missing");
+    for (int i = 0; i < 10; i++) {
+        auto it = rows[i].find(value);
+        ASSERT_NE(rows[i].end(), it);
+        EXPECT_EQ(i * i, it->second);
+        EXPECT_EQ(rows[i].end(), rows[i].find(missing));
+    }
+}
+
+TEST(shaped_object, member_key_private_shape) {
+    // a private shape changes in place, the slot must not be remembered
+    object obj;
+    for (int i = 0; i < 70; i++)
+        obj["k" + std::to_string(i)] = i;
+    ASSERT_FALSE(obj.shape().shared());
+
+    member_key key("k50");
+    ASSERT_NE(obj.end(), obj.find(key));
+    EXPECT_EQ(50, obj.find(key)->second);
+    EXPECT_EQ(1u, obj.erase("k0"));
+    ASSERT_NE(obj.end(), obj.find(key));
+    EXPECT_EQ(50, obj.find(key)->second);
+    EXPECT_EQ(1u, obj.erase("k50"));
+    EXPECT_EQ(obj.end(), obj.find(key));
+}
+
+TEST(shaped_object, large) {
+    // beyond max_shared_size the shape belongs to the object
+    object obj;
+    std::map<std::string, int> expected;
+    std::mt19937_64 rng(2026);
+    for (int i = 0; i < 20000; i++) {
+        auto key = "k" + std::to_string(rng() % 500);
+        if (rng() % 4 == 0) {
+            EXPECT_EQ(expected.erase(key), obj.erase(key));
+        } else {
+            obj[interned_key(key)] = i;
+            expected[key] = i;
+        }
+    }
+    EXPECT_FALSE(obj.shape().shared());
+    ASSERT_EQ(expected.size(), obj.size());
+    for (const auto& i : expected)
+        EXPECT_EQ(i.second, obj.at(i.first)) << i.first;
+
+    object copy = obj;
+    EXPECT_NE(&obj.shape(), &copy.shape());
+    EXPECT_TRUE(copy == obj);
+}
+
+TEST(shaped_json, parse) {
+    const char* const text =
+        "[{\"id\":1,\"name\":\"a\",\"tags\":[]},{\"id\":2,\"name\":\"b\","
+        "\"tags\":[\"x\"]},{\"name\":\"c\",\"id\":3},{}]";
+    shaped_json j;
+    ASSERT_TRUE(j.parse(text));
+    EXPECT_EQ(text, j.dump());
+
+    using object_t = shaped_json::object_t;
+    auto& rows = j.get<shaped_json::array_t&>();
+    EXPECT_EQ(&rows[0].get<object_t&>().shape(),
+              &rows[1].get<object_t&>().shape());
+    EXPECT_NE(&rows[0].get<object_t&>().shape(),
+              &rows[2].get<object_t&>().shape());
+
+    EXPECT_EQ(2, j[1]["id"].get<int>());
+    EXPECT_EQ("c", j[2].value("name", ""));
+    j[3]["added"] = true;
+    EXPECT_TRUE(j[3].contains("added"));
+
+    shaped_json copy = j;
+    EXPECT_TRUE(copy == j);
+
+    microlife::ordered_json ordered;
+    ASSERT_TRUE(ordered.parse(j.dump()));
+    EXPECT_EQ(ordered.dump(), j.dump());
+}
@@ -0,0 +1,76 @@
+#include "microlife/detail/simd.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random> // mt19937_64
+#include <string> // string
+
+using simd = microlife::detail::simd;
+
+namespace {
+// the levels compiled in and supported by this CPU
+std::vector<simd::level> supported_levels() {
+    std::vector<simd::level> ret = {simd::level::scalar};
+    auto best = simd::detect();
+    if (best >= simd::level::sse2)
+        ret.push_back(simd::level::sse2);
+    if (best >= simd::level::avx2)
+        ret.push_back(simd::level::avx2);
+    return ret;
+}
+
+// every kernel agrees with the scalar code on every suffix of str
+void expect_same(const std::string& str) {
+    const char* last = str.data() + str.size();
+    for (std::size_t i = 0; i <= str.size(); i++) {
+        const char* first = str.data() + i;
+        const char* expected = simd::find_escape_scalar(first, last);
+        for (auto l : supported_levels()) {
+            auto f = simd::find_escape_function(l);
+            ASSERT_NE(nullptr, f);
+            EXPECT_EQ(expected, f(first, last))
+                << "level " << int(l) << ", offset " << i << ": " << str;
+        }
+        EXPECT_EQ(expected, simd::find_escape(first, last));
+    }
+}
+} // namespace
+
+TEST(simd, find_escape) {
+    std::string clean(100, 'a');
+    expect_same(clean);
+    expect_same("");
+
+    // each special byte at each position of a 70 byte string
+    const char specials[] = {'"', '\\', '\0', '\x01', '\n', '\x1F'};
+    for (char special : specials) {
+        for (std::size_t pos = 0; pos < 70; pos++) {
+            std::string s(70, 'x');
+            s[pos] = special;
+            expect_same(s);
+        }
+    }
+
+    // bytes that must NOT be found: space, DEL, UTF-8, signed char range
+    std::string others;
+    for (int ch = 0x20; ch < 0x100; ch++) {
+        if (ch != '"' && ch != '\\')
+            others.push_back(char(ch));
+    }
+    EXPECT_EQ(others.data() + others.size(),
+              simd::find_escape(others.data(), others.data() + others.size()));
+    expect_same(others);
+}
+
+TEST(simd, random) {
+    std::mt19937_64 rng(2026);
+    for (int i = 0; i < 2000; i++) {
+        std::string s(rng() % 100, '\0');
+        for (auto& ch : s) {
+            // mostly clean, sometimes special
+            auto r = rng() % 64;
+            ch = r == 0 ? char(rng() % 0x20) : r == 1 ? '"' : char(0x20 + r);
+        }
+        expect_same(s);
+    }
+}
@@ -0,0 +1,121 @@
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory_resource> // memory_resource
+#include <string_view>     // string_view
+
+using sso_json = microlife::sso::json;
+using value_t = sso_json::value_t;
+
+namespace {
+// small strings, allocating from a std::pmr::memory_resource
+struct pmr_sso_policy : microlife::detail::pmr_json_policy {
+    template <typename JsonValue>
+    using storage_t = microlife::detail::small_string_storage<JsonValue>;
+
+    static constexpr bool small_strings = true;
+};
+using pmr_sso_json = microlife::detail::basic_json<pmr_sso_policy>;
+
+class counting_resource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t outstanding = 0; // bytes not yet deallocated
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        allocations++;
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const
+        noexcept override {
+        return this == &other;
+    }
+};
+
+const std::string inline_max(14, 'i');  // longest inline string
+const std::string heap_min(15, 'h');    // shortest heap string
+const std::string with_null("a\0b", 3); // embedded null byte
+} // namespace
+
+TEST(sso_json, size) { EXPECT_EQ(sizeof(microlife::json), sizeof(sso_json)); }
+
+TEST(sso_json, string) {
+    for (const auto& str :
+         {std::string(), std::string("id"), inline_max, heap_min, with_null,
+          std::string(1000, 'x')}) {
+        sso_json j(str);
+        ASSERT_TRUE(j.is_string());
+        EXPECT_EQ(str, j.get<std::string>());
+        EXPECT_EQ(std::string_view(str), j.get<std::string_view>());
+        EXPECT_EQ(str, j.get<sso_json::string_t>());
+
+        sso_json copy = j;
+        EXPECT_TRUE(copy == j);
+        EXPECT_EQ(std::string_view(str), copy.get<std::string_view>());
+
+        sso_json moved = std::move(copy);
+        EXPECT_TRUE(copy.is_null());
+        EXPECT_EQ(std::string_view(str), moved.get<std::string_view>());
+    }
+
+    EXPECT_EQ("", sso_json(value_t::string).get<std::string>());
+    EXPECT_EQ("abc", sso_json("abc").get<std::string>());
+    EXPECT_FALSE(sso_json("abc") == sso_json("abd"));
+    EXPECT_FALSE(sso_json(inline_max) == sso_json(heap_min));
+
+    // every policy reads strings as std::string_view
+    microlife::json plain("plain");
+    EXPECT_EQ("plain", plain.get<std::string_view>());
+}
+
+TEST(sso_json, allocations) {
+    counting_resource resource;
+    {
+        pmr_sso_json small(inline_max.c_str(), &resource);
+        EXPECT_EQ(0u, resource.allocations);
+
+        pmr_sso_json copy(small, &resource);
+        EXPECT_EQ(0u, resource.allocations);
+
+        // one block for the size and the characters
+        pmr_sso_json large(heap_min.c_str(), &resource);
+        EXPECT_EQ(1u, resource.allocations);
+        EXPECT_EQ(heap_min, large.get<std::string>());
+
+        pmr_sso_json j(&resource);
+        ASSERT_TRUE(j.parse(R"(["ok","done","id_12345678",)"
+                            R"("a string longer than fourteen bytes"])"));
+        EXPECT_EQ(R"(["ok","done","id_12345678",)"
+                  R"("a string longer than fourteen bytes"])",
+                  std::string(j.dump()));
+    }
+    EXPECT_EQ(0u, resource.outstanding);
+}
+
+TEST(sso_json, parse) {
+    const char* const text =
+        "{\"description\":\"a string longer than fourteen bytes\","
+        "\"status\":\"active\",\"tags\":[\"a\",\"\",\"x\\ny\\u0000z\"]}";
+    sso_json j;
+    ASSERT_TRUE(j.parse(text));
+    EXPECT_EQ(text, j.dump());
+
+    auto& object = j.get<sso_json::object_t&>();
+    EXPECT_EQ("active", object["status"].get<std::string_view>());
+    auto& tags = object["tags"].get<sso_json::array_t&>();
+    EXPECT_EQ(std::string_view("x\ny\0z", 5), tags[2].get<std::string_view>());
+
+    microlife::json plain;
+    ASSERT_TRUE(plain.parse(text));
+    EXPECT_EQ(plain.dump(), j.dump());
+}
@@ -0,0 +1,144 @@
+#include "microlife/detail/structural_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint> // uint32_t
+#include <random>  // mt19937_64
+#include <string>  // string
+#include <vector>  // vector
+
+using structural_index = microlife::detail::structural_index;
+using level = structural_index::level;
+using simd = microlife::detail::simd;
+
+namespace {
+// the levels compiled in and supported by this CPU
+std::vector<level> supported_levels() {
+    std::vector<level> ret = {level::scalar};
+    auto best = simd::detect();
+    if (best >= level::sse2)
+        ret.push_back(level::sse2);
+    if (best >= level::avx2)
+        ret.push_back(level::avx2);
+    return ret;
+}
+
+// the positions found by every kernel, which must agree
+std::vector<std::uint32_t> positions(const std::string& str,
+                                     bool expect_ok = true) {
+    std::vector<std::uint32_t> expected;
+    bool first = true;
+    for (auto l : supported_levels()) {
+        structural_index index;
+        EXPECT_EQ(expect_ok, index.build(str.data(), str.data() + str.size(),
+                                         l))
+            << "level " << int(l) << ": " << str;
+        std::vector<std::uint32_t> found(index.begin(), index.end());
+        if (first)
+            expected = found;
+        else
+            EXPECT_EQ(expected, found) << "level " << int(l) << ": " << str;
+        first = false;
+    }
+    return expected;
+}
+
+// the tokens of str are the characters marked by '^' in marks
+void expect_tokens(const std::string& str, const std::string& marks) {
+    std::vector<std::uint32_t> expected;
+    for (std::size_t i = 0; i < marks.size(); i++) {
+        if (marks[i] == '^')
+            expected.push_back(std::uint32_t(i));
+    }
+    EXPECT_EQ(expected, positions(str)) << str;
+}
+} // namespace
+
+TEST(structural_index, tokens) {
+    expect_tokens(R"({"a": [1, -2.5, true , "b"]})",
+                  R"(^^ ^^ ^^^ ^   ^ ^    ^ ^ ^^^)");
+    // structural characters inside strings are not tokens
+    expect_tokens(R"(["{[:,", "]}"])",
+                  R"(^^    ^^ ^  ^^)");
+    // escaped quotes
+    expect_tokens(R"("a\"b" "c\\" x)",
+                  R"(^    ^ ^   ^ ^)");
+    expect_tokens(" 1 2 3\t\n",
+                  " ^ ^ ^");
+    expect_tokens("", "");
+    expect_tokens(" \r\n\t", "");
+}
+
+TEST(structural_index, block_boundaries) {
+    // runs of backslashes and quotes across the 64 byte blocks: the
+    // quote after an even run closes the string, after an odd one not
+    for (std::size_t pos = 50; pos < 140; pos++) {
+        for (int run = 1; run <= 5; run++) {
+            std::string str = "[\"" + std::string(pos, 'x') +
+                              std::string(std::size_t(run), '\\') +
+                              "\"" + (run % 2 ? "\"" : "") + ",1]";
+            auto found = positions(str);
+            ASSERT_EQ(6u, found.size()) << str;
+            EXPECT_EQ(str.size() - 4, found[2]) << str; // closing quote
+        }
+    }
+
+    // a scalar across the boundary is one token
+    for (std::size_t pos = 55; pos < 70; pos++) {
+        std::string str = std::string(pos, ' ') + "123456789012";
+        EXPECT_EQ(std::vector<std::uint32_t>{std::uint32_t(pos)},
+                  positions(str));
+    }
+}
+
+TEST(structural_index, growth) {
+    // every byte a token: the array grows past its first guess, and an
+    // index reused for a shorter input keeps only the new positions
+    std::string dense(5000, '[');
+    for (auto l : supported_levels()) {
+        structural_index index;
+        ASSERT_TRUE(index.build(dense.data(), dense.data() + dense.size(), l));
+        ASSERT_EQ(dense.size(), index.size());
+        for (std::uint32_t i = 0; i < index.size(); i++)
+            ASSERT_EQ(i, index.begin()[i]);
+
+        ASSERT_TRUE(index.build(dense.data(), dense.data() + 3, l));
+        EXPECT_EQ(3u, index.size());
+    }
+}
+
+TEST(structural_index, errors) {
+    positions(R"(["abc)", false);
+    positions("[\"a\x01\"]", false);
+    positions(R"(["\"])", false);
+    for (std::size_t pos = 0; pos < 130; pos++)
+        positions(std::string(pos, ' ') + "\"" + std::string(pos, 'a'),
+                  false);
+
+    // a control character outside of a string is a token for stage 2
+    expect_tokens("[\x01]", "^^^");
+}
+
+TEST(structural_index, random) {
+    // every kernel agrees with the scalar one on noise made of the bytes
+    // that matter
+    const char alphabet[] = "\"\\{}[]:, \t\n\rab1\x01\x7F\x80\xFF";
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 2000; i++) {
+        std::string str(std::size_t(rng() % 300), ' ');
+        for (auto& c : str)
+            c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        std::vector<std::vector<std::uint32_t>> results;
+        std::vector<bool> oks;
+        for (auto l : supported_levels()) {
+            structural_index index;
+            oks.push_back(
+                index.build(str.data(), str.data() + str.size(), l));
+            results.emplace_back(index.begin(), index.end());
+        }
+        for (std::size_t k = 1; k < results.size(); k++) {
+            EXPECT_EQ(oks[0], oks[k]);
+            EXPECT_EQ(results[0], results[k]);
+        }
+    }
+}
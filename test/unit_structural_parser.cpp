@@ -0,0 +1,168 @@
+#include "microlife/json.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>    // mt19937_64
+#include <stdexcept> // runtime_error
+#include <string>    // string, to_string
+
+using json = microlife::json;
+using structural_parser = microlife::structural_parser;
+using document = microlife::document;
+using value_t = json::value_t;
+
+namespace {
+// a document with every kind of value, about size bytes
+std::string make_document(std::size_t size) {
+    std::string out = "[";
+    for (int i = 0; out.size() < size; i++) {
+        if (i != 0)
+            out += ",\n  ";
+        out += "{\"id\": " + std::to_string(i) +
+               ", \"name\": \"user \\\"" + std::to_string(i * 7) +
+               "\\\"\", \"ok\": " + (i % 2 ? "true" : "false") +
+               ", \"score\": " + std::to_string(i) + ".25e-1" +
+               ", \"none\": null, \"tags\": [\"a\", \"\\u00e9\", []], " +
+               "\"nested\": {\"k\": {}, \"big\": 18446744073709551615}}";
+    }
+    return out + "]";
+}
+
+// both parsers accept str, or both reject it
+void expect_same(const std::string& str) {
+    json expected, found;
+    structural_parser p;
+    bool ok = expected.parse(str);
+    EXPECT_EQ(ok, p.parse(str, found)) << str;
+    EXPECT_EQ(ok, p.accept(str)) << str;
+    if (ok) {
+        EXPECT_EQ(expected, found) << str;
+    }
+}
+} // namespace
+
+TEST(structural_parser, parse) {
+    const auto text = make_document(20000);
+    json expected, found;
+    ASSERT_TRUE(expected.parse(text));
+    structural_parser p;
+    ASSERT_TRUE(p.parse(text, found));
+    EXPECT_EQ(expected, found);
+    EXPECT_EQ(expected.dump(), found.dump());
+    EXPECT_EQ(value_t::number_unsigned,
+              found[0]["nested"]["big"].type());
+
+    // the parser keeps its index for the next input
+    ASSERT_TRUE(p.parse("  [1, \"a\"]  ", found));
+    EXPECT_EQ("[1,\"a\"]", found.dump());
+    for (const char* str : {"1", "-0.5e3", "\"s\"", "true", "null", "[]",
+                            "{}", " [ [ ] , { } ] "})
+        expect_same(str);
+}
+
+TEST(structural_parser, errors) {
+    for (const char* str :
+         {"", " ", "[", "]", "[1,]", "[1 2]", "{\"a\"}", "{\"a\":}",
+          "{\"a\":1,}", "{1:2}", "[\"a]", "tru", "truex", "nul", "[1]x",
+          "[01]", "[1.]", "[-]", "1e400", "[\"\\x\"]", "[\"\\ud800\"]",
+          "[\"a\x01\"]", "{\"a\" 1}", "[1:2]", "{\"a\":1:2}", "[,1]",
+          "\"a\"\"b\"", "[\"a\"1]", "[true false]", "{]", "[}"})
+        expect_same(str);
+}
+
+TEST(structural_parser, mutations) {
+    // every single byte change of a valid document is accepted or
+    // rejected by both parsers
+    const std::string text = R"({"a": [1, -2.5e3, "x\"y", true, null],)"
+                             R"( "b\\": {"c": false, "d": []}})";
+    const char replacements[] = "\"\\{}[]:, 1-.eE+tfnu\x01";
+    for (std::size_t i = 0; i < text.size(); i++) {
+        for (char c : replacements) {
+            if (c == '\0')
+                continue;
+            std::string str = text;
+            str[i] = c;
+            expect_same(str);
+        }
+        // and a deleted byte
+        expect_same(text.substr(0, i) + text.substr(i + 1));
+    }
+}
+
+TEST(structural_parser, sax) {
+    // integers, as with parser
+    struct sax_sum {
+        std::int64_t sum = 0;
+        std::size_t strings = 0;
+        bool null() { return true; }
+        bool boolean(bool) { return true; }
+        bool number(double) { return false; }
+        bool number_integer(std::int64_t v) {
+            sum += v;
+            return true;
+        }
+        bool string(std::string& s) {
+            strings += s.size();
+            return true;
+        }
+        bool start_object() { return true; }
+        bool key(std::string&) { return true; }
+        bool end_object() { return true; }
+        bool start_array() { return true; }
+        bool end_array() { return true; }
+    } sax;
+    structural_parser p;
+    EXPECT_TRUE(p.sax_parse(R"([1, {"a": -3, "b": "xy\n"}, 9007199254740993])",
+                            &sax));
+    EXPECT_EQ(9007199254740991, sax.sum);
+    EXPECT_EQ(3u, sax.strings);
+
+    // a handler stops the parse
+    EXPECT_FALSE(p.sax_parse("[1.5]", &sax));
+}
+
+TEST(structural_parser, handler_throws) {
+    // the parser is reused after a handler threw inside open arrays
+    struct sax_throw {
+        bool null() { return true; }
+        bool boolean(bool) { return true; }
+        bool number(double) { throw std::runtime_error("number"); }
+        bool string(std::string&) { return true; }
+        bool start_object() { return true; }
+        bool key(std::string&) { return true; }
+        bool end_object() { return true; }
+        bool start_array() { return true; }
+        bool end_array() { return true; }
+    } sax;
+    structural_parser p;
+    EXPECT_THROW(p.sax_parse("[[1]]", &sax), std::runtime_error);
+    EXPECT_TRUE(p.accept("true"));
+    json j;
+    EXPECT_TRUE(p.parse("[2]", j));
+    EXPECT_EQ(2, j[0].get<int>());
+}
+
+TEST(structural_parser, document) {
+    const auto text = make_document(5000);
+    document::parse_options structural;
+    structural.structural = true;
+
+    document expected, doc;
+    ASSERT_TRUE(expected.parse(text));
+    ASSERT_TRUE(doc.parse(text, structural));
+    EXPECT_EQ(expected.root(), doc.root());
+    EXPECT_EQ(expected.dump(), doc.dump());
+
+    // with borrowed strings and lazy numbers
+    structural.lazy_numbers = true;
+    ASSERT_TRUE(doc.borrow(text, structural));
+    EXPECT_EQ(expected.root(), doc.root());
+    EXPECT_EQ("user \"7\"", doc.root()[1]["name"].get<std::string>());
+
+    std::string buffer = text;
+    ASSERT_TRUE(doc.parse_in_situ(&buffer[0], buffer.size(), structural));
+    EXPECT_EQ(expected.root(), doc.root());
+
+    EXPECT_FALSE(doc.parse("[1,]", structural));
+    EXPECT_TRUE(doc.root().is_null());
+}